@@ -1,2 +1,5 @@
-python3 ./vc/checker.py ub ./cmake-build-debug/PP_AE_VC --time_limit 20 --max_time_limit_exceeded 1
-# python3 ./vc/checker.py lb ./cmake-build-debug/PP_AE_VC
+# build-base is the plain release build, the baseline of pgo.sh
+cmake -S . -B build-base -DCMAKE_BUILD_TYPE=Release > /dev/null && cmake --build build-base -j"$(nproc)" > /dev/null || exit 1
+python3 ./vc/checker.py ub ./build-base/PP_AE_VC --time_limit 20 --max_time_limit_exceeded 1
+# python3 ./vc/checker.py lb "./build-base/PP_AE_VC --mode lb"
+# python3 ./vc/checker.py exact "./build-base/PP_AE_VC --mode exact --time-limit 55"
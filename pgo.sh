@@ -0,0 +1,48 @@
+#!/bin/bash
+# Builds the release variants and reports the speedup of each over the
+# plain -O3 build, measured with PP_AE_VC_bench:
+#   native  -march=native
+#   lto     link time optimization
+#   pgo     lto + profile guided, trained on the solver pipelines
+# usage: ./pgo.sh [train filter] [bench filter] [reps]
+# By default the profile is trained on vc2a and the speedup is measured
+# on vc1, so the benchmark does not run on the training data. Both are
+# subsets that all phases finish quickly.
+set -e
+cd "$(dirname "$0")"
+TRAIN=${1:-vc2a}
+BENCH=${2:-vc1}
+REPS=${3:-5}
+if [[ "$BENCH" == "$TRAIN"* || "$TRAIN" == "$BENCH"* ]]; then
+    echo "warning: training set $TRAIN and benchmark set $BENCH overlap" >&2
+fi
+PHASES=parse_csr,csr_to_graph,deg_one,clique_cover_lb,lpb,max_deg_heur,ub_degeneracy,ub_min_degree_mis
+
+build() {
+    local name=$1
+    shift
+    cmake -S . -B build-$name -DCMAKE_BUILD_TYPE=Release "$@" > /dev/null
+    cmake --build build-$name -j"$(nproc)" > /dev/null
+}
+
+build base
+build native -DVC_NATIVE=ON
+build lto -DVC_LTO=ON
+
+# instrumented build, then a training run over the subset
+rm -rf build-pgo/pgo
+build pgo -DVC_LTO=ON -DVC_PGO=GENERATE
+for f in vc/in/${TRAIN}*.in; do
+    for ub in max_deg degeneracy mis; do ./build-pgo/PP_AE_VC --ub $ub < "$f" > /dev/null; done
+    ./build-pgo/PP_AE_VC --mode lb --time-limit 2 < "$f" > /dev/null
+    ./build-pgo/PP_AE_VC --mode exact --time-limit 2 < "$f" > /dev/null
+done
+./build-pgo/PP_AE_VC_bench --filter "$TRAIN" --phases $PHASES --reps 1 > /dev/null
+build pgo -DVC_LTO=ON -DVC_PGO=USE
+
+./build-base/PP_AE_VC_bench --filter "$BENCH" --phases $PHASES --reps "$REPS" > build-base/bench.csv
+for variant in native lto pgo; do
+    echo "== $variant"
+    ./build-$variant/PP_AE_VC_bench --filter "$BENCH" --phases $PHASES --reps "$REPS" \
+        --baseline build-base/bench.csv --tolerance 1 2>&1 > build-$variant/bench.csv | grep SPEEDUP || true
+done
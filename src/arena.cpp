@@ -0,0 +1,91 @@
+#include "arena.h"
+
+#include <cstdlib>
+
+
+thread_local Arena* current_arena = nullptr;
+
+
+static void arena_add_block(Arena* arena, unsigned long size) {
+    if (size < arena->block_size) size = arena->block_size;
+    arena->blocks.push_back(static_cast<char*>(std::malloc(size)));
+    arena->sizes.push_back(size);
+    arena->pos = 0;
+}
+
+
+void* arena_alloc(Arena* arena, unsigned long size, unsigned long align) {
+    if (!arena->blocks.empty()) {
+        unsigned long start = (arena->pos + align - 1) & ~(align - 1);
+        if (start + size <= arena->sizes.back()) {
+            arena->pos = start + size;
+            return arena->blocks.back() + start;
+        }
+    }
+    // malloc memory is max_align_t aligned, so offset 0 fits every alignment
+    arena_add_block(arena, size);
+    arena->pos = size;
+    return arena->blocks.back();
+}
+
+
+static unsigned long node_class(unsigned long size) {
+    return size == 0 ? 0 : (size - 1) / ARENA_NODE_ALIGN;
+}
+
+
+void* arena_alloc_node(Arena* arena, unsigned long size) {
+    void** list = &arena->free_nodes[node_class(size)];
+    if (*list) {
+        void* p = *list;
+        *list = *static_cast<void**>(p);
+        return p;
+    }
+    return arena_alloc(arena, (node_class(size) + 1) * ARENA_NODE_ALIGN, ARENA_NODE_ALIGN);
+}
+
+
+void arena_free_node(Arena* arena, void* p, unsigned long size) {
+    void** list = &arena->free_nodes[node_class(size)];
+    *static_cast<void**>(p) = *list;
+    *list = p;
+}
+
+
+static void clear_free_nodes(Arena* arena) {
+    for (void*& list: arena->free_nodes) list = nullptr;
+}
+
+
+void arena_reset(Arena* arena) {
+    if (arena->blocks.size() > 1) {
+        // replace all blocks by one large block, so the next round fits in it
+        unsigned long total = 0;
+        for (unsigned long size: arena->sizes) total += size;
+        arena_destroy(arena);
+        arena_add_block(arena, total);
+    }
+    arena->pos = 0;
+    clear_free_nodes(arena);
+}
+
+
+void arena_destroy(Arena* arena) {
+    for (char* block: arena->blocks) std::free(block);
+    arena->blocks.clear();
+    arena->sizes.clear();
+    arena->pos = 0;
+    clear_free_nodes(arena);
+}
+
+
+struct ScratchArena {
+    Arena arena;
+    ~ScratchArena() { arena_destroy(&arena); }
+};
+
+
+Arena* scratch_arena() {
+    static thread_local ScratchArena scratch;
+    return &scratch.arena;
+}
@@ -0,0 +1,152 @@
+/*
+ *
+ * Arena allocation.
+ * A monotonic arena owns all storage of one graph: edge array,
+ * indicators and every std::set / std::map node. Large blocks are never
+ * given back one by one, the whole arena is dropped at once. Small
+ * blocks (container nodes) that are freed go to a free list per size
+ * class and are handed out again, so erased set nodes get reused.
+ *
+ * Every thread also has a scratch arena for temporaries
+ * (bipartite graph of lpb, clique sets, ...). It is reset after use.
+ *
+ */
+
+#ifndef PP_AE_VC_ARENA_H
+#define PP_AE_VC_ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <set>
+#include <map>
+#include <scoped_allocator>
+
+
+// small blocks are rounded up to a multiple of ARENA_NODE_ALIGN
+static const unsigned long ARENA_NODE_ALIGN = 16;
+static const unsigned long ARENA_NODE_MAX = 256;
+
+
+typedef struct __arena {
+    std::vector<char*> blocks;
+    std::vector<unsigned long> sizes;
+    unsigned long pos = 0;
+    unsigned long block_size = 1 << 20;
+    // freed small blocks, one list per size class, linked through their first word
+    void* free_nodes[ARENA_NODE_MAX / ARENA_NODE_ALIGN] = {};
+} Arena;
+
+
+void* arena_alloc(Arena* arena, unsigned long size, unsigned long align = alignof(std::max_align_t));
+
+/*
+ * Small block (at most ARENA_NODE_MAX bytes, ARENA_NODE_ALIGN aligned),
+ * taken from the free list of its size class if possible.
+ */
+void* arena_alloc_node(Arena* arena, unsigned long size);
+
+/*
+ * Puts a block of arena_alloc_node back on its free list.
+ */
+void arena_free_node(Arena* arena, void* p, unsigned long size);
+
+/*
+ * Makes all memory of the arena available again.
+ * ATENTION: nothing allocated from the arena may be used afterwards.
+ * This includes running destructors of containers that live in it.
+ */
+void arena_reset(Arena* arena);
+
+/*
+ * Frees all blocks. O(number of blocks).
+ */
+void arena_destroy(Arena* arena);
+
+template<typename T>
+T* arena_new_array(Arena* arena, unsigned long n) {
+    T* p = static_cast<T*>(arena_alloc(arena, n * sizeof(T) + (n == 0), alignof(T)));
+    for (unsigned long i = 0; i < n; i++) new (p + i) T();
+    return p;
+}
+
+
+/*
+ * Arena default-constructed containers allocate from.
+ * nullptr means the normal heap.
+ */
+extern thread_local Arena* current_arena;
+
+/*
+ * Per thread arena for temporaries.
+ */
+Arena* scratch_arena();
+
+/*
+ * Sets current_arena for the lifetime of the scope.
+ */
+class ArenaScope {
+public:
+    explicit ArenaScope(Arena* arena) : previous(current_arena) { current_arena = arena; }
+    ~ArenaScope() { current_arena = previous; }
+private:
+    Arena* previous;
+};
+
+
+/*
+ * std allocator on top of an arena. Small blocks (container nodes) are
+ * recycled through the free lists of the arena, deallocate of larger
+ * arena memory is a no-op.
+ * A default constructed allocator uses current_arena.
+ */
+template<typename T>
+struct ArenaAllocator {
+    typedef T value_type;
+
+    Arena* arena;
+
+    ArenaAllocator() : arena(current_arena) {}
+    explicit ArenaAllocator(Arena* arena) : arena(arena) {}
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    static bool is_node(std::size_t n) {
+        return n * sizeof(T) <= ARENA_NODE_MAX && alignof(T) <= ARENA_NODE_ALIGN;
+    }
+
+    T* allocate(std::size_t n) {
+        if (!arena) return static_cast<T*>(::operator new(n * sizeof(T)));
+        if (is_node(n)) return static_cast<T*>(arena_alloc_node(arena, n * sizeof(T)));
+        return static_cast<T*>(arena_alloc(arena, n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) {
+        if (!arena) ::operator delete(p);
+        else if (is_node(n)) arena_free_node(arena, p, n * sizeof(T));
+    }
+};
+
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena == b.arena; }
+
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena != b.arena; }
+
+
+/*
+ * Containers used by Graph.
+ * ArenaMap hands its allocator down to sets stored as values,
+ * so a set inside a graph always lives in the arena of that graph.
+ */
+template<typename T>
+using ArenaSet = std::set<T, std::less<T>, ArenaAllocator<T>>;
+
+template<typename K, typename V>
+using ArenaMap = std::map<K, V, std::less<K>, std::scoped_allocator_adaptor<ArenaAllocator<std::pair<const K, V>>>>;
+
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+
+#endif //PP_AE_VC_ARENA_H
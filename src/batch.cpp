@@ -0,0 +1,240 @@
+#include "batch.h"
+
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <iomanip>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "reader.h"
+#include "order.h"
+#include "verify.h"
+#include "parallel.h"
+
+
+typedef struct __batch_row {
+    std::string file;
+    std::string status;
+    double points = 0;
+    unsigned long long read_ns = 0;
+    unsigned long long reduce_ns = 0;
+    unsigned long long solve_ns = 0;
+    unsigned long long verify_ns = 0;
+    std::string error;
+} BatchRow;
+
+
+static std::string base_name(const std::string& path) {
+    unsigned long slash = path.find_last_of('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+
+/*
+ * path without trailing slashes ("vc/in/" -> "vc/in"), "/" stays.
+ */
+static std::string strip_slashes(std::string path) {
+    while (path.size() > 1 && path.back() == '/') path.pop_back();
+    return path;
+}
+
+
+static std::string dir_name(const std::string& path) {
+    std::string stripped = strip_slashes(path);
+    unsigned long slash = stripped.find_last_of('/');
+    if (slash == std::string::npos) return ".";
+    return slash == 0 ? "/" : stripped.substr(0, slash);
+}
+
+
+/*
+ * Paths of all instances, sorted for a directory, in file order for a manifest.
+ */
+static std::vector<std::string> list_batch(const std::string& batch) {
+    std::string path = strip_slashes(batch);
+    std::vector<std::string> files;
+    struct stat info;
+    if (stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode)) {
+        DIR* d = opendir(path.c_str());
+        if (!d) return files;
+        while (struct dirent* entry = readdir(d)) {
+            std::string name = entry->d_name;
+            if (name.size() < 3 || name.compare(name.size() - 3, 3, ".in") != 0) continue;
+            files.push_back(path + "/" + name);
+        }
+        closedir(d);
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+
+    std::ifstream manifest(path);
+    std::string line;
+    while (std::getline(manifest, line)) {
+        std::istringstream stream(line.substr(0, line.find('#')));
+        std::string file;
+        if (stream >> file) files.push_back(file);
+    }
+    return files;
+}
+
+
+/*
+ * First number of the reference solution (the optimum), like vc/chk.py.
+ * Returns false if there is none.
+ */
+static bool read_reference(const std::string& path, unsigned long* size) {
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream stream(line);
+        return (bool) (stream >> *size);
+    }
+    return false;
+}
+
+
+static unsigned long long elapsed_ns(std::chrono::steady_clock::time_point* since) {
+    auto now = std::chrono::steady_clock::now();
+    unsigned long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - *since).count();
+    *since = now;
+    return ns;
+}
+
+
+static void run_instance(const std::string& path, const std::string& ref_dir, Options options,
+                         uint64_t stream, BatchRow* row) {
+    row->file = base_name(path);
+    options.threads = 1;
+    options.deadline = deadline_after(options.time_limit);
+    Rng rng;
+    rng_seed(&rng, options.seed, stream);
+    auto clock = std::chrono::steady_clock::now();
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        row->status = "Wrong";
+        row->error = "can not open " + path;
+        return;
+    }
+    InputBuffer input;
+    input_open(&input, fd);
+    Csr csr = csr_read(input.data, input.size, 1, options.format, &row->error);
+    input_close(&input);
+    close(fd);
+    if (!row->error.empty()) {
+        row->status = "Wrong";
+        return;
+    }
+    csr_reorder(&csr, options.order);
+    // graph_from_csr keeps the ids of csr, covers are checked on csr
+    Graph* graph = graph_from_csr(&csr);
+    row->read_ns = elapsed_ns(&clock);
+
+    std::stack<bool*> res_stack;
+    BoundAccount account;
+    run_reductions(graph, &options, &res_stack, &account);
+    account_raise_total(&account, csr.forced.size() + csr.matching.size() / 2);
+    row->reduce_ns = elapsed_ns(&clock);
+
+    std::vector<uint32_t> cover;
+    unsigned long bound = 0;
+    bool optimal = true;
+    if (options.mode == "lb") {
+        Csr kernel = csr_from_graph(graph);
+        bound = run_lower_bound(&kernel, &options, &account);
+    } else {
+        if (options.mode == "exact") {
+            std::vector<bool*> nodes;
+            Csr kernel = csr_from_graph(graph, &nodes);
+            for (uint32_t v: run_exact(&kernel, &options, &rng, &optimal, &account)) res_stack.push(nodes[v]);
+        } else {
+            run_upper_bound(graph, &options, &res_stack, &rng);
+        }
+        while (!res_stack.empty()) {
+            cover.push_back(node_id(res_stack.top(), graph));
+            res_stack.pop();
+        }
+    }
+    delete_graph(graph);
+    row->solve_ns = elapsed_ns(&clock);
+
+    unsigned long opt = 0;
+    bool has_ref = read_reference(ref_dir + "/" + row->file.substr(0, row->file.size() - 3) + ".out", &opt);
+    row->status = "OK";
+    if (options.mode == "lb") {
+        if (has_ref && bound > opt) {
+            row->status = "Wrong";
+            row->error = "lower bound is too large";
+        }
+        row->points = opt == 0 ? 1.0 : (double) bound / opt;
+    } else {
+        std::vector<uint32_t> with_forced = cover;
+        bool valid = verify_cover(&csr, cover);
+        // self-loop nodes are not in csr, they have to be in the cover anyway
+        std::sort(with_forced.begin(), with_forced.end());
+        for (uint32_t v: csr.forced) {
+            if (!std::binary_search(with_forced.begin(), with_forced.end(), v)) valid = false;
+        }
+        if (!valid) {
+            row->status = "Wrong";
+            row->error = "edge not covered";
+        } else if (options.mode == "exact" && !optimal) {
+            row->status = "timelimit";
+        } else if (options.mode == "exact" && has_ref && cover.size() > opt) {
+            row->status = "Wrong";
+            row->error = "too many nodes";
+        }
+        if (options.mode == "ub") row->points = cover.empty() ? 1.0 : (double) opt / cover.size();
+        // exact scores one point per solved instance
+        if (options.mode == "exact") row->points = row->status == "OK" ? 1.0 : 0.0;
+    }
+    // without the optimum nothing can be scored, the row does not count
+    if (!has_ref && row->status == "OK") {
+        row->status = "unscored";
+        row->error = "no reference";
+    }
+    if (!has_ref || row->status == "Wrong") row->points = 0;
+    row->verify_ns = elapsed_ns(&clock);
+}
+
+
+int run_batch(const Options* options) {
+    std::vector<std::string> files = list_batch(options->batch);
+    std::string ref_dir = options->batch_ref;
+    if (ref_dir.empty()) {
+        // vc/in/x.in -> vc/out/x.out
+        std::string in_dir = files.empty() ? options->batch : dir_name(files[0]);
+        ref_dir = dir_name(in_dir) + "/out";
+    }
+
+    std::vector<BatchRow> rows(files.size());
+    std::atomic<unsigned long> next{0};
+    run_parallel(std::min<unsigned long>(options->threads, std::max<unsigned long>(files.size(), 1)), [&](unsigned long) {
+        for (unsigned long i = next++; i < files.size(); i = next++) {
+            run_instance(files[i], ref_dir, *options, i, &rows[i]);
+        }
+    });
+
+    double score = 0;
+    unsigned long unscored = 0;
+    bool wrong = false;
+    std::cout << "file,status,points,time,read_ns,reduce_ns,solve_ns,verify_ns,error" << std::endl;
+    for (const auto& row: rows) {
+        unsigned long long total = row.read_ns + row.reduce_ns + row.solve_ns + row.verify_ns;
+        std::cout << row.file << "," << row.status << "," << row.points << ","
+                  << std::fixed << std::setprecision(3) << total / 1e9 << std::defaultfloat << std::setprecision(6) << ","
+                  << row.read_ns << "," << row.reduce_ns << "," << row.solve_ns << "," << row.verify_ns << ","
+                  << row.error << std::endl;
+        score += row.points;
+        unscored += row.status == "unscored";
+        wrong |= row.status == "Wrong";
+    }
+    std::cout << "overall score: " << score << std::endl;
+    if (unscored > 0) std::cout << "unscored (no reference): " << unscored << std::endl;
+    return wrong ? 1 : 0;
+}
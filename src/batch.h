@@ -0,0 +1,33 @@
+/*
+ *
+ * In-process batch runner.
+ * Solves every instance of a directory (all *.in files) or of a manifest
+ * (one path per line, '#' starts a comment) in one process, one instance
+ * per worker thread (--threads). Every instance gets its own deadline
+ * (--time-limit) and runs single threaded.
+ *
+ * Writes the checker csv to stdout, one row per instance in input order:
+ *   file,status,points,time,read_ns,reduce_ns,solve_ns,verify_ns,error
+ * status is OK, Wrong, timelimit or unscored (valid, but there is no
+ * reference solution; 0 points, counted separately below the score).
+ * error says why a row is Wrong or unscored (empty otherwise). Covers are verified against the
+ * input graph, sizes and bounds are compared against the optimum in
+ * --batch-ref (default: the out directory next to the in directory).
+ * points are scored like vc/chk.py (ub: opt / size, lb: lb / opt),
+ * exact gets one point per solved instance.
+ *
+ */
+
+#ifndef PP_AE_VC_BATCH_H
+#define PP_AE_VC_BATCH_H
+
+#include "pipeline.h"
+
+
+/*
+ * Returns 0 if no instance was Wrong, 1 otherwise.
+ */
+int run_batch(const Options* options);
+
+
+#endif //PP_AE_VC_BATCH_H
@@ -0,0 +1,373 @@
+/*
+ *
+ * In-process benchmark harness.
+ * Loads every instance of a directory (default vc/in) into memory once
+ * and times the single phases separately with repetitions:
+ * parse, deg_one, basic_lb, clique_cover_lb, lpb, max_deg_heur and
+ * max_deg_heur_rand (seeded with --seed, so runs are comparable),
+ * ub_degeneracy and ub_min_degree_mis (timed on the Csr of the kernel),
+ * ub_min_degree_mis_packed (on the compressed kernel, value is the cover
+ * size, bytes per adjacency entry go to stderr).
+ * bnb is the exact search on the kernel with --threads workers, only
+ * meant for instances it solves quickly and not in the default phases:
+ *   PP_AE_VC_bench --filter vc2a --phases bnb --threads 4
+ * parse_csr is the parallel reader with --threads threads, csr_to_graph
+ * the conversion of its result into a Graph.
+ * Apart from parse, all phases get their graph the way the solver loads
+ * it: csr_read, relabeled with --order, graph_from_csr.
+ *
+ * Output is one row per (file, phase) with median and p95 in ms plus
+ * the value the phase computed (forced nodes, bound, cover size).
+ * With --baseline a previous csv output is compared against, phases
+ * slower than --tolerance are reported as regressions and the speedup
+ * per phase goes to stderr (pgo.sh uses it to compare build variants).
+ *
+ * Usage:
+ *   PP_AE_VC_bench [--dir vc/in] [--filter vc1] [--reps 5]
+ *                  [--phases parse,deg_one,...] [--format csv|json]
+ *                  [--baseline old.csv] [--tolerance 0.1] [--seed 1]
+ *                  [--threads 1] [--order none|degeneracy|bfs|rcm]
+ *
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <stack>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <dirent.h>
+
+#include "graph.h"
+#include "lb.h"
+#include "dr.h"
+#include "ub.h"
+#include "csr.h"
+#include "reader.h"
+#include "order.h"
+#include "core.h"
+#include "bnb.h"
+
+
+
+typedef struct __bench_row {
+    std::string file;
+    std::string phase;
+    unsigned long reps;
+    double median_ms;
+    double p95_ms;
+    unsigned long value;
+} BenchRow;
+
+
+std::vector<std::string> list_instances(const std::string& dir, const std::string& filter) {
+    std::vector<std::string> files;
+    DIR* d = opendir(dir.c_str());
+    if (!d) return files;
+    while (struct dirent* entry = readdir(d)) {
+        std::string name = entry->d_name;
+        if (name.size() < 3 || name.compare(name.size() - 3, 3, ".in") != 0) continue;
+        if (name.compare(0, filter.size(), filter) != 0) continue;
+        files.push_back(name);
+    }
+    closedir(d);
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+
+std::vector<std::string> split(const std::string& s, char sep) {
+    std::vector<std::string> parts;
+    std::stringstream stream(s);
+    std::string part;
+    while (std::getline(stream, part, sep)) {
+        if (!part.empty()) parts.push_back(part);
+    }
+    return parts;
+}
+
+
+Graph* parse(const std::string& text) {
+    std::istringstream in(text);
+    return readin(in);
+}
+
+
+/*
+ * Runs one phase on a freshly parsed graph.
+ * Only the phase itself is inside the timed region.
+ * Returns the elapsed time in ns and writes the phase result into value.
+ */
+Graph* load(const std::string& text, unsigned long threads, const std::string& order) {
+    std::string error;
+    Csr csr = csr_read(text.data(), text.size(), threads, "auto", &error);
+    if (!error.empty()) {
+        std::cerr << error << std::endl;
+        exit(2);
+    }
+    csr_reorder(&csr, order);
+    return graph_from_csr(&csr);
+}
+
+
+unsigned long long run_phase(const std::string& phase, const std::string& text, uint64_t seed,
+                             unsigned long threads, const std::string& order, unsigned long* value) {
+    using clock = std::chrono::steady_clock;
+    clock::time_point start, end;
+
+    if (phase == "parse_csr") {
+        start = clock::now();
+        Csr csr = csr_read(text.data(), text.size(), threads);
+        end = clock::now();
+        *value = csr.n;
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    }
+    if (phase == "csr_to_graph") {
+        Csr csr = csr_read(text.data(), text.size(), threads);
+        start = clock::now();
+        Graph* graph = graph_from_csr(&csr);
+        end = clock::now();
+        *value = graph->n;
+        delete_graph(graph);
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    }
+
+    if (phase == "parse") {
+        start = clock::now();
+        Graph* graph = parse(text);
+        end = clock::now();
+        *value = graph->n;
+        delete_graph(graph);
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    }
+
+    Graph* graph = load(text, threads, order);
+    std::stack<bool*> res_stack;
+
+    if (phase == "deg_one") {
+        start = clock::now();
+        *value = deg_one(graph, &res_stack);
+        end = clock::now();
+    } else if (phase == "basic_lb") {
+        start = clock::now();
+        *value = basic_lb(graph);
+        end = clock::now();
+    } else if (phase == "clique_cover_lb") {
+        start = clock::now();
+        *value = clique_cover_lb(graph);
+        end = clock::now();
+    } else if (phase == "lpb") {
+        start = clock::now();
+        *value = lpb(graph);
+        end = clock::now();
+    } else if (phase == "max_deg_heur") {
+        // timed on the kernel the submission pipeline hands to it
+        unsigned long forced = deg_one(graph, &res_stack);
+        start = clock::now();
+        *value = forced + max_deg_heur(graph, &res_stack);
+        end = clock::now();
+    } else if (phase == "max_deg_heur_rand") {
+        unsigned long forced = deg_one(graph, &res_stack);
+        Rng rng;
+        rng_seed(&rng, seed);
+        start = clock::now();
+        *value = forced + max_deg_heur_rand(graph, &res_stack, &rng);
+        end = clock::now();
+    } else if (phase == "ub_degeneracy" || phase == "ub_min_degree_mis") {
+        unsigned long forced = deg_one(graph, &res_stack);
+        Csr kernel = csr_from_graph(graph);
+        start = clock::now();
+        if (phase == "ub_degeneracy") {
+            Cores cores = core_decomposition(&kernel);
+            *value = forced + ub_degeneracy(&kernel, &cores).size();
+        } else {
+            *value = forced + ub_min_degree_mis(&kernel).size();
+        }
+        end = clock::now();
+    } else if (phase == "ub_min_degree_mis_packed") {
+        unsigned long forced = deg_one(graph, &res_stack);
+        Csr kernel = csr_from_graph(graph);
+        PackedCsr packed = pack_csr(&kernel);
+        start = clock::now();
+        *value = forced + ub_min_degree_mis(&packed).size();
+        end = clock::now();
+        if (!kernel.adj.empty()) std::cerr << "packed bytes/entry " << (double) packed.bytes.size() / kernel.adj.size() << std::endl;
+    } else if (phase == "bnb") {
+        unsigned long forced = deg_one(graph, &res_stack);
+        Csr kernel = csr_from_graph(graph);
+        std::vector<uint32_t> initial = ub_min_degree_mis(&kernel);
+        start = clock::now();
+        *value = forced + bnb_solve(&kernel, initial, clock::time_point::max(), threads).cover.size();
+        end = clock::now();
+    } else {
+        std::cerr << "unknown phase " << phase << std::endl;
+        delete_graph(graph);
+        exit(2);
+    }
+
+    delete_graph(graph);
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+
+double percentile_ms(std::vector<unsigned long long> times, double p) {
+    std::sort(times.begin(), times.end());
+    // nearest rank
+    unsigned long rank = (unsigned long) (p * times.size() + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > times.size()) rank = times.size();
+    return times[rank - 1] / 1e6;
+}
+
+
+double median_ms(std::vector<unsigned long long> times) {
+    std::sort(times.begin(), times.end());
+    unsigned long mid = times.size() / 2;
+    if (times.size() % 2) return times[mid] / 1e6;
+    return (times[mid - 1] + times[mid]) / 2e6;
+}
+
+
+void print_csv(const std::vector<BenchRow>& rows) {
+    std::cout << "file,phase,reps,median_ms,p95_ms,value" << std::endl;
+    for (const auto& row: rows) {
+        std::cout << row.file << "," << row.phase << "," << row.reps << ","
+                  << row.median_ms << "," << row.p95_ms << "," << row.value << std::endl;
+    }
+}
+
+
+void print_json(const std::vector<BenchRow>& rows) {
+    std::cout << "[" << std::endl;
+    for (unsigned long i = 0; i < rows.size(); i++) {
+        const BenchRow& row = rows[i];
+        std::cout << "  {\"file\": \"" << row.file << "\", \"phase\": \"" << row.phase
+                  << "\", \"reps\": " << row.reps << ", \"median_ms\": " << row.median_ms
+                  << ", \"p95_ms\": " << row.p95_ms << ", \"value\": " << row.value << "}"
+                  << (i + 1 < rows.size() ? "," : "") << std::endl;
+    }
+    std::cout << "]" << std::endl;
+}
+
+
+/*
+ * Reads a csv written by print_csv.
+ * Key is "file,phase", value is the median in ms.
+ */
+std::map<std::string, double> read_baseline(const std::string& path) {
+    std::map<std::string, double> baseline;
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line); // header
+    while (std::getline(file, line)) {
+        std::vector<std::string> cols = split(line, ',');
+        if (cols.size() < 6) continue;
+        baseline[cols[0] + "," + cols[1]] = std::stod(cols[3]);
+    }
+    return baseline;
+}
+
+
+/*
+ * Reports every phase whose median got slower than baseline * (1 + tolerance),
+ * then the speedup per phase and in total (sums of the medians over all
+ * files in both runs). Returns the number of regressions.
+ */
+unsigned long compare_baseline(const std::vector<BenchRow>& rows, const std::map<std::string, double>& baseline, double tolerance) {
+    unsigned long regressions = 0;
+    std::map<std::string, std::pair<double, double>> sums;   // phase -> (baseline, now)
+    for (const auto& row: rows) {
+        auto ref = baseline.find(row.file + "," + row.phase);
+        if (ref == baseline.end()) continue;
+        sums[row.phase].first += ref->second;
+        sums[row.phase].second += row.median_ms;
+        // ignore noise on phases that take less than a tenth of a ms
+        if (row.median_ms < 0.1 && ref->second < 0.1) continue;
+        if (row.median_ms > ref->second * (1 + tolerance)) {
+            std::cerr << "REGRESSION " << row.file << " " << row.phase << " "
+                      << ref->second << "ms -> " << row.median_ms << "ms" << std::endl;
+            regressions++;
+        }
+    }
+
+    std::pair<double, double> total;
+    std::cerr << std::fixed << std::setprecision(3);
+    for (const auto& sum: sums) {
+        total.first += sum.second.first;
+        total.second += sum.second.second;
+        std::cerr << "SPEEDUP " << sum.first << " " << sum.second.first << "ms -> " << sum.second.second << "ms x"
+                  << (sum.second.second > 0 ? sum.second.first / sum.second.second : 1.0) << std::endl;
+    }
+    std::cerr << "SPEEDUP total " << total.first << "ms -> " << total.second << "ms x"
+              << (total.second > 0 ? total.first / total.second : 1.0) << std::endl;
+    return regressions;
+}
+
+
+int main(int argc, char** argv) {
+    std::string dir = "vc/in";
+    std::string filter;
+    std::string format = "csv";
+    std::string baseline_path;
+    unsigned long reps = 5;
+    double tolerance = 0.1;
+    uint64_t seed = 1;
+    unsigned long threads = 1;
+    std::string order = "none";
+    std::vector<std::string> phases = {"parse", "parse_csr", "csr_to_graph", "deg_one", "basic_lb", "clique_cover_lb", "lpb", "max_deg_heur", "max_deg_heur_rand", "ub_degeneracy", "ub_min_degree_mis", "ub_min_degree_mis_packed"};
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "missing value for " << arg << std::endl;
+            return 2;
+        }
+        if (arg == "--dir") dir = argv[++i];
+        else if (arg == "--filter") filter = argv[++i];
+        else if (arg == "--reps") reps = std::stoul(argv[++i]);
+        else if (arg == "--phases") phases = split(argv[++i], ',');
+        else if (arg == "--format") format = argv[++i];
+        else if (arg == "--baseline") baseline_path = argv[++i];
+        else if (arg == "--tolerance") tolerance = std::stod(argv[++i]);
+        else if (arg == "--seed") seed = std::stoull(argv[++i]);
+        else if (arg == "--threads") threads = std::stoul(argv[++i]);
+        else if (arg == "--order") order = argv[++i];
+        else {
+            std::cerr << "unknown option " << arg << std::endl;
+            return 2;
+        }
+    }
+    if (reps == 0) reps = 1;
+
+    std::vector<BenchRow> rows;
+    for (const auto& name: list_instances(dir, filter)) {
+        // load once, every repetition parses from memory
+        std::ifstream file(dir + "/" + name);
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        std::string text = buffer.str();
+
+        for (const auto& phase: phases) {
+            std::vector<unsigned long long> times;
+            unsigned long value = 0;
+            for (unsigned long r = 0; r < reps; r++) {
+                times.push_back(run_phase(phase, text, seed, threads, order, &value));
+            }
+            rows.push_back({name, phase, reps, median_ms(times), percentile_ms(times, 0.95), value});
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(4);
+    if (format == "json") print_json(rows);
+    else print_csv(rows);
+
+    if (!baseline_path.empty()) {
+        if (compare_baseline(rows, read_baseline(baseline_path), tolerance) > 0) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,421 @@
+#include "bnb.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "core.h"
+#include "incumbent.h"
+#include "narrow.h"
+#include "overlay.h"
+#include "parallel.h"
+#include "stats.h"
+
+
+typedef struct __bnb_step {
+    uint32_t v;
+    bool neighbours;   // false: v was taken, true: the neighbours of v were taken
+} BnbStep;
+
+
+/*
+ * Deque of one worker. The owner pushes and pops at the back,
+ * thieves steal at the front, where the subproblems near the root are.
+ * A subproblem is the branching path from the root.
+ */
+typedef struct __bnb_deque {
+    std::mutex lock;
+    std::deque<std::vector<BnbStep>> tasks;
+} BnbDeque;
+
+
+/*
+ * G is the graph type with_index_width() picked (see narrow.h).
+ */
+template<typename G>
+struct BnbShared {
+    const G* csr;
+    std::vector<uint32_t> core;      // core numbers of csr, tie breaker for branching
+    Incumbent* incumbent;
+    std::chrono::steady_clock::time_point deadline;
+    std::vector<BnbDeque> deques;
+    std::atomic<unsigned long> pending{0};   // tasks pushed and not finished
+    std::atomic<unsigned long> idle{0};      // workers looking for work
+    std::atomic<bool> stop{false};
+    std::atomic<bool> timeout{false};
+
+    explicit BnbShared(unsigned long threads) : deques(threads) {}
+};
+
+
+template<typename G>
+struct BnbState {
+    const G* csr;
+    BnbShared<G>* shared;
+    unsigned long id;                // worker
+    std::vector<char> alive;
+    std::vector<uint32_t> degree;
+    std::vector<uint32_t> trail;     // removed nodes, in removal order
+    std::vector<char> in_cover;      // per trail entry: was it taken into the cover
+    std::vector<uint32_t> cover;     // current partial cover
+    std::vector<BnbStep> path;       // branching decisions from the root
+    unsigned long edges;             // edges left
+    unsigned long nodes = 0;
+    std::vector<char> matched;       // scratch for the matching bound
+    Overlay<G> view;                 // this state, as base for probes
+    Overlay<G> probe;
+};
+
+
+template<typename G>
+static void remove_node(BnbState<G>* s, uint32_t v, bool take) {
+    s->alive[v] = 0;
+    for_each_neighbour(s->csr, v, [&](uint32_t u) {
+        if (s->alive[u]) s->degree[u]--;
+        return true;
+    });
+    s->edges -= s->degree[v];
+    s->trail.push_back(v);
+    s->in_cover.push_back(take);
+    if (take) s->cover.push_back(v);
+}
+
+
+template<typename G>
+static void undo_to(BnbState<G>* s, unsigned long mark) {
+    while (s->trail.size() > mark) {
+        uint32_t v = s->trail.back();
+        bool taken = s->in_cover.back();
+        s->trail.pop_back();
+        s->in_cover.pop_back();
+        if (taken) s->cover.pop_back();
+        s->alive[v] = 1;
+        for_each_neighbour(s->csr, v, [&](uint32_t u) {
+            if (s->alive[u]) s->degree[u]++;
+            return true;
+        });
+        s->edges += s->degree[v];
+    }
+}
+
+
+/*
+ * Degree zero: drop. Degree one: take the neighbour.
+ * Repeats until nothing changes.
+ */
+template<typename G>
+static void reduce(BnbState<G>* s) {
+    const G* csr = s->csr;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (uint32_t v = 0; v < csr->n; v++) {
+            if (!s->alive[v]) continue;
+            if (s->degree[v] == 0) {
+                remove_node(s, v, false);
+            } else if (s->degree[v] == 1) {
+                uint32_t neighbour = UINT32_MAX;
+                for_each_neighbour(csr, v, [&](uint32_t u) {
+                    if (!s->alive[u]) return true;
+                    neighbour = u;
+                    return false;
+                });
+                remove_node(s, neighbour, true);
+                remove_node(s, v, false);
+                changed = true;
+            }
+        }
+    }
+}
+
+
+/*
+ * Size of a greedy maximal matching of the remaining graph.
+ */
+template<typename G>
+static unsigned long matching_bound(BnbState<G>* s) {
+    const G* csr = s->csr;
+    unsigned long size = 0;
+    std::fill(s->matched.begin(), s->matched.end(), 0);
+    for (uint32_t v = 0; v < csr->n; v++) {
+        if (!s->alive[v] || s->matched[v]) continue;
+        for_each_neighbour(csr, v, [&](uint32_t u) {
+            if (!s->alive[u] || s->matched[u]) return true;
+            s->matched[u] = 1;
+            s->matched[v] = 1;
+            size++;
+            return false;
+        });
+    }
+    return size;
+}
+
+
+template<typename G>
+static void push_task(BnbShared<G>* shared, unsigned long id, std::vector<BnbStep> path) {
+    shared->pending.fetch_add(1);
+    std::lock_guard<std::mutex> guard(shared->deques[id].lock);
+    shared->deques[id].tasks.push_back(std::move(path));
+}
+
+
+template<typename G>
+static bool pop_task(BnbShared<G>* shared, unsigned long id, std::vector<BnbStep>* path) {
+    std::lock_guard<std::mutex> guard(shared->deques[id].lock);
+    if (shared->deques[id].tasks.empty()) return false;
+    *path = std::move(shared->deques[id].tasks.back());
+    shared->deques[id].tasks.pop_back();
+    return true;
+}
+
+
+template<typename G>
+static bool steal_task(BnbShared<G>* shared, unsigned long id, std::vector<BnbStep>* path) {
+    for (unsigned long i = 1; i < shared->deques.size(); i++) {
+        BnbDeque& victim = shared->deques[(id + i) % shared->deques.size()];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (victim.tasks.empty()) continue;
+        *path = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+
+template<typename G>
+static bool own_deque_empty(BnbShared<G>* shared, unsigned long id) {
+    std::lock_guard<std::mutex> guard(shared->deques[id].lock);
+    return shared->deques[id].tasks.empty();
+}
+
+
+template<typename G>
+static void apply_step(BnbState<G>* s, BnbStep step) {
+    if (!step.neighbours) {
+        remove_node(s, step.v, true);
+    } else {
+        for_each_neighbour(s->csr, step.v, [&](uint32_t u) {
+            if (s->alive[u]) remove_node(s, u, true);
+            return true;
+        });
+    }
+    s->path.push_back(step);
+}
+
+
+/*
+ * Lower bound for the cover added by a branch, probed on an overlay:
+ * nodes the branch takes, what the degree rules then take, and the
+ * edges left divided by max_degree (degrees only drop below it).
+ */
+template<typename G>
+static unsigned long probe_branch(BnbState<G>* s, BnbStep step, uint32_t max_degree) {
+    overlay_init(&s->view, s->csr, &s->alive, &s->degree, s->edges);
+    overlay_fork(&s->probe, &s->view);
+    if (!step.neighbours) {
+        overlay_remove(&s->probe, step.v, true);
+    } else {
+        for_each_neighbour(s->csr, step.v, [&](uint32_t u) {
+            if (s->alive[u]) overlay_remove(&s->probe, u, true);
+            return true;
+        });
+    }
+    overlay_reduce(&s->probe);
+    unsigned long lb = s->probe.taken + (s->probe.edges + max_degree - 1) / max_degree;
+    overlay_discard(&s->probe);
+    return lb;
+}
+
+
+template<typename G>
+static bool probe_prunes(BnbState<G>* s, BnbStep step, uint32_t max_degree) {
+    if (s->cover.size() + probe_branch(s, step, max_degree) < incumbent_size(s->shared->incumbent)) return false;
+    STATS_INC(bnb_probe_prunes);
+    return true;
+}
+
+
+template<typename G>
+static void branch(BnbState<G>* s) {
+    const G* csr = s->csr;
+    BnbShared<G>* shared = s->shared;
+    if (shared->stop.load(std::memory_order_relaxed)) return;
+    if ((++s->nodes & 1023) == 0 && std::chrono::steady_clock::now() >= shared->deadline) {
+        shared->timeout = true;
+        shared->stop = true;
+        return;
+    }
+
+    unsigned long mark = s->trail.size();
+    reduce(s);
+
+    if (s->edges == 0) {
+        if (s->cover.size() < incumbent_size(shared->incumbent)) {
+            incumbent_offer(shared->incumbent, s->cover);
+            if (incumbent_optimal(shared->incumbent)) shared->stop = true;
+        }
+        undo_to(s, mark);
+        return;
+    }
+
+    uint32_t v = 0;
+    uint32_t max_degree = 0;
+    for (uint32_t u = 0; u < csr->n; u++) {
+        if (!s->alive[u]) continue;
+        // ties go to the node of the deeper core
+        if (s->degree[u] > max_degree || (s->degree[u] == max_degree && shared->core[u] > shared->core[v])) {
+            max_degree = s->degree[u];
+            v = u;
+        }
+    }
+
+    unsigned long lb = std::max(matching_bound(s), (s->edges + max_degree - 1) / max_degree);
+    if (s->path.empty()) {
+        // root of the whole search, lb holds for every cover
+        incumbent_raise_lower_bound(shared->incumbent, s->cover.size() + lb);
+        if (incumbent_optimal(shared->incumbent)) shared->stop = true;
+    }
+    if (s->cover.size() + lb >= incumbent_size(shared->incumbent)) {
+        undo_to(s, mark);
+        return;
+    }
+
+    // hand the second branch to an idle worker instead of doing it here
+    bool split = shared->idle.load(std::memory_order_relaxed) > 0 && own_deque_empty(shared, s->id);
+    if (split && !probe_prunes(s, {v, true}, max_degree)) {
+        std::vector<BnbStep> task = s->path;
+        task.push_back({v, true});
+        push_task(shared, s->id, std::move(task));
+    }
+
+    // take v
+    if (!probe_prunes(s, {v, false}, max_degree)) {
+        unsigned long inner = s->trail.size();
+        apply_step(s, {v, false});
+        branch(s);
+        undo_to(s, inner);
+        s->path.pop_back();
+    }
+
+    // take all neighbours of v
+    if (!split && !probe_prunes(s, {v, true}, max_degree)) {
+        apply_step(s, {v, true});
+        branch(s);
+        s->path.pop_back();
+    }
+    undo_to(s, mark);
+}
+
+
+/*
+ * Replays path on the (fully undone) state of the worker and searches below it.
+ * Every step is preceded by reduce(), exactly like in branch().
+ */
+template<typename G>
+static void run_task(BnbState<G>* s, const std::vector<BnbStep>& path) {
+    for (BnbStep step: path) {
+        reduce(s);
+        apply_step(s, step);
+    }
+    branch(s);
+    undo_to(s, 0);
+    s->path.clear();
+}
+
+
+template<typename G>
+static void worker(BnbState<G>* s) {
+    BnbShared<G>* shared = s->shared;
+    bool waiting = false;
+    std::vector<BnbStep> path;
+    while (!shared->stop.load(std::memory_order_relaxed)) {
+        if (pop_task(shared, s->id, &path) || steal_task(shared, s->id, &path)) {
+            if (waiting) shared->idle.fetch_sub(1);
+            waiting = false;
+            run_task(s, path);
+            shared->pending.fetch_sub(1);
+            continue;
+        }
+        if (shared->pending.load() == 0) break;
+        if (!waiting) shared->idle.fetch_add(1);
+        waiting = true;
+        std::this_thread::yield();
+    }
+    if (waiting) shared->idle.fetch_sub(1);
+}
+
+
+/*
+ * The search itself, on the graph type picked by bnb_solve.
+ * Returns the number of search nodes, *timeout if the deadline hit.
+ */
+template<typename G>
+static unsigned long search(const G* csr, const Csr* plain, Incumbent* incumbent,
+                            std::chrono::steady_clock::time_point deadline, unsigned long threads, bool* timeout) {
+    BnbShared<G> shared(threads);
+    shared.csr = csr;
+    shared.core = core_decomposition(plain).core;
+    shared.incumbent = incumbent;
+    shared.deadline = deadline;
+
+    std::vector<BnbState<G>> states(threads);
+    for (unsigned long t = 0; t < threads; t++) {
+        BnbState<G>& s = states[t];
+        s.csr = csr;
+        s.shared = &shared;
+        s.id = t;
+        s.alive.assign(csr->n, 1);
+        s.degree.resize(csr->n);
+        for (uint32_t v = 0; v < csr->n; v++) s.degree[v] = degree_of(csr, v);
+        s.edges = csr->m;
+        s.matched.assign(csr->n, 0);
+    }
+
+    push_task(&shared, 0, {});
+    run_parallel(threads, [&](unsigned long t) {
+        worker(&states[t]);
+    });
+
+    *timeout = shared.timeout;
+    unsigned long nodes = 0;
+    for (const auto& s: states) nodes += s.nodes;
+    return nodes;
+}
+
+
+BnbResult bnb_solve(const Csr* csr, const std::vector<uint32_t>& initial,
+                    std::chrono::steady_clock::time_point deadline, unsigned long threads,
+                    unsigned long lower_bound) {
+    if (threads < 1) threads = 1;
+    Incumbent incumbent;
+    if (initial.empty() && csr->m > 0) {
+        // no upper bound given, start from the trivial cover
+        std::vector<uint32_t> all(csr->n);
+        for (uint32_t v = 0; v < csr->n; v++) all[v] = v;
+        incumbent_offer(&incumbent, all);
+    } else {
+        incumbent_offer(&incumbent, initial);
+    }
+    incumbent_raise_lower_bound(&incumbent, lower_bound);
+
+    incumbent.phase = "bnb";
+
+    BnbResult result;
+    result.optimal = true;
+    result.nodes = 0;
+    if (!incumbent_optimal(&incumbent)) {
+        // otherwise the start cover already meets the known bound
+        bool timeout = false;
+        result.nodes = with_index_width(csr, [&](const auto* g) {
+            return search(g, csr, &incumbent, deadline, threads, &timeout);
+        });
+        result.optimal = !timeout;
+        // a finished search proves the incumbent optimal
+        if (result.optimal) incumbent_raise_lower_bound(&incumbent, incumbent_size(&incumbent));
+    }
+    result.cover = incumbent_cover(&incumbent);
+    return result;
+}
@@ -0,0 +1,52 @@
+/*
+ *
+ * Exact branch and bound.
+ * Works on a Csr with alive flags, degrees and an undo trail,
+ * so nothing is copied while branching.
+ * Branches on a node of maximum degree: take it, or take all its neighbours.
+ * Ties are broken by core number.
+ * Degree zero and degree one nodes are reduced in every search node.
+ * Before a branch is entered it is probed on a copy-on-write overlay
+ * (see overlay.h) and skipped if its bound cannot beat the incumbent.
+ *
+ * With several threads every worker has its own state and undo trail.
+ * While some worker is idle, a worker puts the second branch of its
+ * current search node on its deque, as the path of decisions from the
+ * root. Idle workers steal the oldest path and replay it on their own
+ * state. The best cover size is shared through an Incumbent for pruning.
+ *
+ * The search runs on the narrowest index width that fits the graph
+ * (see narrow.h).
+ *
+ */
+
+#ifndef PP_AE_VC_BNB_H
+#define PP_AE_VC_BNB_H
+
+#include <chrono>
+#include <vector>
+
+#include "csr.h"
+
+
+typedef struct __bnb_result {
+    std::vector<uint32_t> cover;
+    bool optimal;            // false if the deadline stopped the search
+    unsigned long nodes;     // search nodes visited
+} BnbResult;
+
+
+/*
+ * Computes a minimum vertex cover of csr.
+ * initial is a known cover (e.g. from max_deg_heur), used as first upper bound.
+ * Stops at deadline and returns the best cover found so far.
+ * Searches with threads workers.
+ * lower_bound is a known bound on the minimum cover of csr (e.g. from
+ * the lower bound pipeline), the search stops once a cover reaches it.
+ */
+BnbResult bnb_solve(const Csr* csr, const std::vector<uint32_t>& initial,
+                    std::chrono::steady_clock::time_point deadline, unsigned long threads = 1,
+                    unsigned long lower_bound = 0);
+
+
+#endif //PP_AE_VC_BNB_H
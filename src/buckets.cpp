@@ -0,0 +1,46 @@
+#include "buckets.h"
+
+
+void buckets_init(Buckets* b, unsigned long n, unsigned long max_degree) {
+    b->nodes.assign(max_degree + 1, std::vector<unsigned long>());
+    b->degree.assign(n, 0);
+    b->pos.assign(n, 0);
+    b->present.assign(n, false);
+    b->size = 0;
+    b->max_degree = 0;
+}
+
+
+void buckets_insert(Buckets* b, unsigned long id, unsigned long degree) {
+    b->degree[id] = degree;
+    b->pos[id] = b->nodes[degree].size();
+    b->nodes[degree].push_back(id);
+    b->present[id] = true;
+    b->size++;
+    if (degree > b->max_degree) b->max_degree = degree;
+}
+
+
+void buckets_remove(Buckets* b, unsigned long id) {
+    // swap with the last node of the bucket
+    std::vector<unsigned long>& bucket = b->nodes[b->degree[id]];
+    unsigned long last = bucket.back();
+    bucket[b->pos[id]] = last;
+    b->pos[last] = b->pos[id];
+    bucket.pop_back();
+    b->present[id] = false;
+    b->size--;
+}
+
+
+void buckets_set_degree(Buckets* b, unsigned long id, unsigned long degree) {
+    if (b->degree[id] == degree) return;
+    buckets_remove(b, id);
+    buckets_insert(b, id, degree);
+}
+
+
+unsigned long buckets_max_degree(Buckets* b) {
+    while (b->nodes[b->max_degree].empty()) b->max_degree--;
+    return b->max_degree;
+}
@@ -0,0 +1,45 @@
+/*
+ *
+ * Array backed degree buckets.
+ * nodes[d] holds the ids of all nodes with degree d in no particular order.
+ * Insert, remove, degree change and picking the i-th node of a bucket
+ * are O(1). Alternative to node_degree_map where random access or
+ * linear time sweeps are needed.
+ *
+ */
+
+#ifndef PP_AE_VC_BUCKETS_H
+#define PP_AE_VC_BUCKETS_H
+
+#include <vector>
+
+
+typedef struct __buckets {
+    std::vector<std::vector<unsigned long>> nodes;
+    std::vector<unsigned long> degree; // per id
+    std::vector<unsigned long> pos;    // index of the id in nodes[degree[id]]
+    std::vector<bool> present;
+    unsigned long size = 0;
+    unsigned long max_degree = 0;      // upper bound, see buckets_max_degree()
+} Buckets;
+
+
+/*
+ * Empty buckets for ids 0..n-1 and degrees 0..max_degree.
+ */
+void buckets_init(Buckets* b, unsigned long n, unsigned long max_degree);
+
+void buckets_insert(Buckets* b, unsigned long id, unsigned long degree);
+
+void buckets_remove(Buckets* b, unsigned long id);
+
+void buckets_set_degree(Buckets* b, unsigned long id, unsigned long degree);
+
+/*
+ * Largest degree with a non empty bucket. Buckets must not be empty.
+ * Amortized O(1) as long as degrees only decrease.
+ */
+unsigned long buckets_max_degree(Buckets* b);
+
+
+#endif //PP_AE_VC_BUCKETS_H
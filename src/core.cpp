@@ -0,0 +1,98 @@
+#include "core.h"
+
+#include <algorithm>
+
+
+template<typename G>
+static Cores core_impl(const G* csr) {
+    // Batagelj-Zaversnik: nodes sorted by degree in bins, peel the smallest
+    unsigned long n = csr->n;
+    std::vector<uint32_t> degree(n);
+    uint32_t max_degree = 0;
+    for (uint32_t v = 0; v < n; v++) {
+        degree[v] = degree_of(csr, v);
+        max_degree = std::max(max_degree, degree[v]);
+    }
+
+    std::vector<uint32_t> bin(max_degree + 2, 0);
+    for (uint32_t v = 0; v < n; v++) bin[degree[v] + 1]++;
+    for (uint32_t d = 1; d < bin.size(); d++) bin[d] += bin[d - 1];
+
+    std::vector<uint32_t> order(n);
+    std::vector<uint32_t> pos(n);
+    for (uint32_t v = 0; v < n; v++) {
+        pos[v] = bin[degree[v]]++;
+        order[pos[v]] = v;
+    }
+    // bin[d] is the start of the nodes with degree d again
+    for (uint32_t d = max_degree + 1; d > 0; d--) bin[d] = bin[d - 1];
+    bin[0] = 0;
+
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t v = order[i];
+        for_each_neighbour(csr, v, [&](uint32_t u) {
+            if (degree[u] > degree[v]) {
+                // swap u with the first node of its bin, then shrink the bin
+                uint32_t du = degree[u];
+                uint32_t pw = bin[du];
+                uint32_t w = order[pw];
+                if (u != w) {
+                    order[pos[u]] = w;
+                    pos[w] = pos[u];
+                    order[pw] = u;
+                    pos[u] = pw;
+                }
+                bin[du]++;
+                degree[u]--;
+            }
+            return true;
+        });
+    }
+    Cores cores;
+    cores.order.swap(order);
+    // degree of a node when it is peeled is its core number
+    cores.core.swap(degree);
+    for (uint32_t c: cores.core) cores.degeneracy = std::max(cores.degeneracy, c);
+    return cores;
+}
+
+
+template<typename G>
+static std::vector<uint32_t> degeneracy_impl(const G* csr, const Cores* cores) {
+    std::vector<char> independent(csr->n, 0);
+    std::vector<char> blocked(csr->n, 0);
+    for (uint32_t v: cores->order) {
+        if (blocked[v]) continue;
+        independent[v] = 1;
+        for_each_neighbour(csr, v, [&](uint32_t u) {
+            blocked[u] = 1;
+            return true;
+        });
+    }
+
+    std::vector<uint32_t> cover;
+    for (uint32_t v = 0; v < csr->n; v++) {
+        if (!independent[v]) cover.push_back(v);
+    }
+    return cover;
+}
+
+
+Cores core_decomposition(const Csr* csr) {
+    return core_impl(csr);
+}
+
+
+Cores core_decomposition(const PackedCsr* csr) {
+    return core_impl(csr);
+}
+
+
+std::vector<uint32_t> ub_degeneracy(const Csr* csr, const Cores* cores) {
+    return degeneracy_impl(csr, cores);
+}
+
+
+std::vector<uint32_t> ub_degeneracy(const PackedCsr* csr, const Cores* cores) {
+    return degeneracy_impl(csr, cores);
+}
@@ -0,0 +1,43 @@
+/*
+ *
+ * Core decomposition.
+ * Peels nodes of minimum degree (Batagelj-Zaversnik, nodes kept in
+ * degree bins) in O(n + m). The core number of a node is its degree
+ * at the moment it is peeled, the largest core number is the
+ * degeneracy of the graph.
+ *
+ * Used for the degeneracy ordering, the degeneracy upper bound and
+ * as tie breaker when branching.
+ *
+ */
+
+#ifndef PP_AE_VC_CORE_H
+#define PP_AE_VC_CORE_H
+
+#include <vector>
+
+#include "csr.h"
+#include "packed.h"
+
+
+typedef struct __cores {
+    std::vector<uint32_t> core;   // core number per node
+    std::vector<uint32_t> order;  // nodes in peeling order
+    uint32_t degeneracy = 0;
+} Cores;
+
+
+Cores core_decomposition(const Csr* csr);
+
+Cores core_decomposition(const PackedCsr* csr);
+
+/*
+ * Greedy independent set in peeling order (low core nodes first),
+ * returns its complement, which is a vertex cover.
+ */
+std::vector<uint32_t> ub_degeneracy(const Csr* csr, const Cores* cores);
+
+std::vector<uint32_t> ub_degeneracy(const PackedCsr* csr, const Cores* cores);
+
+
+#endif //PP_AE_VC_CORE_H
@@ -0,0 +1,125 @@
+#include "csr.h"
+
+#include <algorithm>
+
+
+Csr csr_from_graph(Graph* graph, std::vector<bool*>* nodes) {
+    Csr csr;
+    std::vector<uint32_t> local(graph->n, UINT32_MAX);
+
+    for (const auto& node: graph->neighbours) {
+        if (!*node.first) continue;
+        local[node_id(node.first, graph)] = csr.n++;
+        if (nodes) nodes->push_back(node.first);
+        csr.labels.push_back(graph->labels[node_id(node.first, graph)]);
+    }
+    for (bool* node: graph->forced) {
+        if (*node) csr.forced.push_back(local[node_id(node, graph)]);
+    }
+    std::sort(csr.forced.begin(), csr.forced.end());
+
+    csr.offsets.reserve(csr.n + 1);
+    csr.offsets.push_back(0);
+    for (const auto& node: graph->neighbours) {
+        if (!*node.first) continue;
+        for (bool* neighbour: std::get<1>(node.second)) {
+            if (*neighbour) csr.adj.push_back(local[node_id(neighbour, graph)]);
+        }
+        // sets are ordered by address, which is id order, so adj stays sorted
+        csr.offsets.push_back(csr.adj.size());
+    }
+    csr.m = csr.adj.size() / 2;
+    return csr;
+}
+
+
+Graph* graph_from_csr(const Csr* csr) {
+    Graph& graph = *new_graph(new Arena());
+    graph.n = csr->n;
+    graph.m = csr->m;
+    graph.edges = arena_new_array<Edge>(graph.arena, csr->m);
+    graph.indicators = arena_new_array<bool>(graph.arena, csr->n);
+
+    for (uint32_t v = 0; v < csr->n; v++) {
+        bool* node = &graph.indicators[v];
+        *node = true;
+        graph.labels.push_back(csr->labels[v]);
+        graph.strings[node] = csr->labels[v];
+        graph.indicatorps[csr->labels[v]] = node;
+
+        unsigned long degree = csr_degree(csr, v);
+        graph.nodecounts[node] = degree;
+        neighbour_map_value& value = graph.neighbours[node];
+        std::get<0>(value) = degree;
+        for (uint64_t i = csr->offsets[v]; i < csr->offsets[v + 1]; i++) {
+            // sorted input, hint at the end
+            std::get<1>(value).insert(std::get<1>(value).end(), &graph.indicators[csr->adj[i]]);
+        }
+        graph.node_degree_map[degree].insert(node);
+    }
+
+    for (uint32_t v: csr->forced) graph.forced.push_back(&graph.indicators[v]);
+
+    unsigned long edgeindex = 0;
+    for (uint32_t v = 0; v < csr->n; v++) {
+        for (uint64_t i = csr->offsets[v]; i < csr->offsets[v + 1]; i++) {
+            if (csr->adj[i] > v) {
+                graph.edges[edgeindex++] = std::make_tuple(&graph.indicators[v], &graph.indicators[csr->adj[i]]);
+            }
+        }
+    }
+    return &graph;
+}
+
+
+std::vector<Csr> csr_components(const Csr* csr) {
+    // component of every node by bfs
+    std::vector<uint32_t> component(csr->n, UINT32_MAX);
+    std::vector<uint32_t> local(csr->n);
+    std::vector<std::vector<uint32_t>> members;
+    std::vector<uint32_t> queue;
+    for (uint32_t root = 0; root < csr->n; root++) {
+        if (component[root] != UINT32_MAX || csr_degree(csr, root) == 0) continue;
+        uint32_t c = members.size();
+        members.emplace_back();
+        queue.assign(1, root);
+        component[root] = c;
+        for (unsigned long head = 0; head < queue.size(); head++) {
+            uint32_t v = queue[head];
+            members[c].push_back(v);
+            for (uint64_t i = csr->offsets[v]; i < csr->offsets[v + 1]; i++) {
+                uint32_t u = csr->adj[i];
+                if (component[u] != UINT32_MAX) continue;
+                component[u] = c;
+                queue.push_back(u);
+            }
+        }
+    }
+
+    // ids keep their relative order, the greedy bounds depend on it
+    for (auto& nodes: members) {
+        std::sort(nodes.begin(), nodes.end());
+        for (uint32_t i = 0; i < nodes.size(); i++) local[nodes[i]] = i;
+    }
+
+    std::vector<Csr> components(members.size());
+    for (uint32_t c = 0; c < members.size(); c++) {
+        Csr& part = components[c];
+        part.n = members[c].size();
+        part.offsets.reserve(part.n + 1);
+        part.offsets.push_back(0);
+        for (uint32_t v: members[c]) {
+            part.labels.push_back(csr->labels[v]);
+            for (uint64_t i = csr->offsets[v]; i < csr->offsets[v + 1]; i++) part.adj.push_back(local[csr->adj[i]]);
+            part.offsets.push_back(part.adj.size());
+        }
+        part.m = part.adj.size() / 2;
+    }
+    for (uint32_t v: csr->forced) {
+        if (component[v] != UINT32_MAX) components[component[v]].forced.push_back(local[v]);
+    }
+    for (Csr& part: components) std::sort(part.forced.begin(), part.forced.end());
+
+    std::stable_sort(components.begin(), components.end(), [](const Csr& a, const Csr& b) { return a.m > b.m; });
+    return components;
+}
@@ -0,0 +1,84 @@
+/*
+ *
+ * Static graph in compressed sparse row form.
+ * Neighbours of v are adj[offsets[v]] .. adj[offsets[v+1] - 1], sorted.
+ * Vertex ids are 0..n-1, labels[v] is the input label of v.
+ * There are no self-loops and no parallel edges in adj. Nodes that had
+ * a self-loop are listed in forced, they belong to every cover.
+ * The reader also leaves a maximal matching of the rest in matching:
+ * forced plus both endpoints is a 2-approximate cover, forced plus the
+ * matching size a lower bound, both available the moment reading ends.
+ *
+ * Graph is the structure reductions work on. A Csr is a flat
+ * snapshot of it (e.g. of the kernel) for solvers and bounds
+ * that want plain arrays.
+ *
+ */
+
+#ifndef PP_AE_VC_CSR_H
+#define PP_AE_VC_CSR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "graph.h"
+
+
+typedef struct __csr {
+    unsigned long n = 0;
+    unsigned long m = 0;
+    std::vector<uint64_t> offsets;
+    std::vector<uint32_t> adj;
+    std::vector<std::string> labels;
+    std::vector<uint32_t> forced;   // nodes with a self-loop, sorted
+    std::vector<uint32_t> matching; // endpoint pairs of a maximal matching without the forced
+                                    // nodes, found while reading (empty for other Csrs)
+} Csr;
+
+
+inline unsigned long csr_degree(const Csr* csr, uint32_t v) {
+    return csr->offsets[v + 1] - csr->offsets[v];
+}
+
+/*
+ * Same interface as for PackedCsr (packed.h), for consumers that take either.
+ */
+inline unsigned long degree_of(const Csr* csr, uint32_t v) {
+    return csr_degree(csr, v);
+}
+
+/*
+ * Calls f(u) for the neighbours u of v in order until f returns false.
+ * Returns false if f stopped the loop.
+ */
+template<typename F>
+inline bool for_each_neighbour(const Csr* csr, uint32_t v, F f) {
+    for (uint64_t i = csr->offsets[v]; i < csr->offsets[v + 1]; i++) {
+        if (!f(csr->adj[i])) return false;
+    }
+    return true;
+}
+
+/*
+ * Snapshot of all nodes of graph that are still in the graph.
+ * Works after delete_node() as well as after delete_node_erase().
+ * If nodes is given, (*nodes)[v] is set to the graph node of csr node v.
+ */
+Csr csr_from_graph(Graph* graph, std::vector<bool*>* nodes = nullptr);
+
+/*
+ * Builds a new Graph (own arena) with the same nodes and edges.
+ * Free it with delete_graph().
+ */
+Graph* graph_from_csr(const Csr* csr);
+
+/*
+ * Splits csr into its connected components with at least one edge,
+ * each a Csr with its own ids 0..n-1 (labels and forced nodes kept).
+ * Largest (by edges) first.
+ */
+std::vector<Csr> csr_components(const Csr* csr);
+
+
+#endif //PP_AE_VC_CSR_H
@@ -1,5 +1,6 @@
 
 #include "graph.h"
+#include "stats.h"
 
 #include <stack>
 
@@ -10,6 +11,7 @@
  *
  * */
 unsigned long deg_one(Graph* graph, std::stack<bool*>* res_stack) {
+    STATS_TIMER(PHASE_DEG_ONE);
     //if (graph->node_degree_map.find(1) == graph->node_degree_map.end()) return 0;
     unsigned long lb = 0;
 
@@ -18,6 +20,7 @@ unsigned long deg_one(Graph* graph, std::stack<bool*>* res_stack) {
         res_stack->push(*(get_node_neighbours(vertex, graph).begin()));
         delete_node_erase(*(get_node_neighbours(vertex, graph).begin()), graph);
         delete_node_erase(vertex, graph);
+        STATS_ADD(deleted_deg_one, 2);
         lb++;
     }
     return lb;
@@ -27,10 +30,12 @@ unsigned long deg_one(Graph* graph, std::stack<bool*>* res_stack) {
 unsigned long deg_zero(Graph* graph) {
     //if (graph->node_degree_map.find(1) == graph->node_degree_map.end()) return 0;
     unsigned long lb = 0;
+    STATS_INC(deg_zero_sweeps);
 
     while (graph->node_degree_map.find(0) != graph->node_degree_map.end()) {
         bool* vertex = *(graph->node_degree_map[0].begin());
         delete_node_erase(vertex, graph);
+        STATS_INC(deleted_deg_zero);
         lb++;
     }
     return lb;
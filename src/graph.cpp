@@ -1,6 +1,7 @@
 
 #include "graph.h"
 #include "dr.h"
+#include "stats.h"
 
 
 #include <iostream>
@@ -26,8 +27,10 @@ void print_deg_map(Graph* graph) {
 
 
 void remove_node_degree(Graph* graph, bool* node) {
+    STATS_INC(bucket_removals);
     graph->node_degree_map[std::get<0>(graph->neighbours[node])].erase(node);
     if (graph->node_degree_map[std::get<0>(graph->neighbours[node])].begin() == graph->node_degree_map[std::get<0>(graph->neighbours[node])].end()) {
+        STATS_INC(bucket_erases);
         graph->node_degree_map.erase(std::get<0>(graph->neighbours[node]));
     }
 }
@@ -87,6 +90,7 @@ void delete_node_erase(bool* node, Graph* graph) {
      * DO NOT USE THIS IF NOT NECESSARY
      *
      */
+    STATS_INC(erase_calls);
     *node = false;
     remove_node_degree(graph, node);
     for (const auto& neighbour: std::get<1>(graph->neighbours[node])) {
@@ -119,7 +123,7 @@ void undelete_node_insert(bool* node, Graph* graph) {
 }
 
 
-std::set<bool*> get_node_neighbours(bool* node, Graph* graph) {
+const NodeSet& get_node_neighbours(bool* node, Graph* graph) {
     ///  a node might not be active eventhough it is in the returned set.
     ///  if a node is not active/not in the graph, its value is set to false
     return std::get<1>(graph->neighbours[node]);
@@ -163,21 +167,52 @@ void print_edge_array(Graph* graph) {
         }
     }
 
-    std::cout << num_nodes << " " << num_edges << std::endl;
+    Out out;
+    out_open(&out);
+    out_ul(&out, num_nodes);
+    out_char(&out, ' ');
+    out_ul(&out, num_edges);
+    out_char(&out, '\n');
 
     // print out edges
     for (int i = 0; i < graph->m; i++) {
         if (*std::get<0>(graph->edges[i]) && *std::get<1>(graph->edges[i])) {
-            std::cout << graph->strings[std::get<0>(graph->edges[i])] << " " << graph->strings[std::get<1>(graph->edges[i])] << std::endl;
+            out_node(&out, node_id(std::get<0>(graph->edges[i]), graph), graph);
+            out_char(&out, ' ');
+            out_node(&out, node_id(std::get<1>(graph->edges[i]), graph), graph);
+            out_char(&out, '\n');
         }
     }
+    out_close(&out);
 }
 
 
+unsigned long node_id(bool* node, Graph* graph) {
+    return node - graph->indicators;
+}
+
+
+void out_node(Out* out, unsigned long id, Graph* graph) {
+    out_string(out, graph->labels[id]);
+}
+
+
+
+Graph* new_graph(Arena* arena) {
+    ArenaScope scope(arena);
+    Graph* graph = new (arena_alloc(arena, sizeof(Graph), alignof(Graph))) Graph();
+    graph->arena = arena;
+    return graph;
+}
+
 
 void delete_graph(Graph* graph){
-    delete(graph->edges);
-    delete(graph->indicators);
+    // edges, indicators and all container nodes are in the arena, but the
+    // bodies of long label strings are on the heap, the destructor frees them
+    Arena* arena = graph->arena;
+    graph->~Graph();
+    arena_destroy(arena);
+    delete arena;
 }
 
 
@@ -191,7 +226,7 @@ void set_m(unsigned long new_m, Graph* graph) {
 }
 
 
-std::map<bool*, unsigned long>* get_nodecounts(Graph* graph) {
+ArenaMap<bool*, unsigned long>* get_nodecounts(Graph* graph) {
     return (&graph->nodecounts);
 }
 
@@ -222,11 +257,12 @@ Edge* get_first_edge(Graph* graph) {
 
 
 
-Graph readin() {
+Graph* readin(std::istream& in) {
+    STATS_TIMER(PHASE_READ);
 
     // DEV
     // std::ifstream file("/home/notna/Uni/algoeng/PP-AE-VC/samples/vc/in/vc1aa.in");
-    Graph graph = Graph();
+    Graph& graph = *new_graph(new Arena());
     //graph.node_degree_map[1] = std::set<bool*>();
     bool b = true;
 
@@ -234,7 +270,7 @@ Graph readin() {
     // TODO: read in Graph size and allocate array edges.
     std::string line;
     int n;
-    while (std::getline(std::cin, line) && !line.empty()) {
+    while (std::getline(in, line) && !line.empty()) {
         if (line[0] == '#') continue;
         std::istringstream isstream(line);
         std::string tempn;
@@ -247,15 +283,15 @@ Graph readin() {
         break;
     }
 
-    graph.edges = new Edge[graph.m];
+    graph.edges = arena_new_array<Edge>(graph.arena, graph.m);
     // maybe queue is better.
-    graph.indicators = new bool[2*graph.m];
+    graph.indicators = arena_new_array<bool>(graph.arena, 2*graph.m);
 
     // TODO: read in Edges and store them in edges and translation
     int edgeindex = 0;
     int indicatorindex = 0;
 
-    while (std::getline(std::cin, line) && !line.empty()) {
+    while (std::getline(in, line) && !line.empty()) {
 
         if (line[0] == '#') continue;
         std::stringstream stream(line);
@@ -264,31 +300,44 @@ Graph readin() {
         stream >> a;
         stream >> b;
         bool *atrans = graph.indicatorps[a];
-        bool *btrans = graph.indicatorps[b];
 
         if (!atrans) {
             graph.indicators[indicatorindex] = true;
             graph.indicatorps[a] = &(graph.indicators)[indicatorindex];
             graph.strings[&(graph.indicators)[indicatorindex]] = a;
+            graph.labels.push_back(a);
             atrans = &(graph.indicators)[indicatorindex];
             graph.nodecounts[atrans] = 0;
 
-            graph.neighbours[atrans] = std::make_tuple(0, std::set<bool *>());
+            graph.neighbours[atrans] = std::make_tuple(0, NodeSet());
 
             indicatorindex++;
         }
+        // looked up after a is inserted, a self-loop must not create two nodes
+        bool *btrans = graph.indicatorps[b];
         if (!btrans) {
             graph.indicators[indicatorindex] = true;
             graph.indicatorps[b] = &(graph.indicators)[indicatorindex];
             graph.strings[&(graph.indicators)[indicatorindex]] = b;
+            graph.labels.push_back(b);
             btrans = &(graph.indicators)[indicatorindex];
             graph.nodecounts[btrans] = 0;
 
-            graph.neighbours[btrans] = std::make_tuple(0, std::set<bool *>());
+            graph.neighbours[btrans] = std::make_tuple(0, NodeSet());
 
             indicatorindex++;
         }
 
+        if (atrans == btrans) {
+            // self-loop: the node is in every cover, see run_reductions()
+            if (std::find(graph.forced.begin(), graph.forced.end(), atrans) == graph.forced.end()) {
+                graph.forced.push_back(atrans);
+            }
+            continue;
+        }
+        // parallel edge: already counted, the sets would drop it anyway
+        if (std::get<1>(graph.neighbours[atrans]).count(btrans)) continue;
+
         graph.nodecounts[atrans]++;
         graph.nodecounts[btrans]++;
         // maybe arrays are faster?
@@ -317,5 +366,7 @@ Graph readin() {
         // edgecounter++;
         edgeindex++;
     }
-    return graph;
+    graph.n = indicatorindex;
+    graph.m = edgeindex;
+    return &graph;
 }
\ No newline at end of file
@@ -2,7 +2,10 @@
 #include <iostream>
 #include <map>
 #include <set>
+#include <vector>
 
+#include "out.h"
+#include "arena.h"
 
 #ifndef PP_AE_VC_GRAPH_H
 #define PP_AE_VC_GRAPH_H
@@ -10,22 +13,34 @@
 
 
 typedef std::tuple<bool*, bool*> Edge;
-typedef std::tuple<unsigned long, std::set<bool*>> neighbour_map_value;
+typedef ArenaSet<bool*> NodeSet;
+typedef std::tuple<unsigned long, NodeSet> neighbour_map_value;
 
 /*
  * New Graph struct to store a Graph.
  * Implemented so it is possible to work with multiple graphs.
  * Manly implemented for LP bound in exercise 04.
  *
+ * All storage of a graph (arrays and container nodes) lives in graph->arena.
+ * Create graphs with new_graph() and free them with delete_graph().
+ *
  * */
 typedef struct __graph {
+    Arena* arena;
     Edge *edges;
     Edge* lastfirstedgeposition;
-    std::map<bool*, std::string> strings;
+    ArenaMap<bool*, std::string> strings;
     unsigned long m = 0;
-    std::map<std::string, bool*> indicatorps;
+    unsigned long n = 0;
+
+    /*
+     * labels[id] is the input label of the node &indicators[id].
+     * Flat copy of strings for the output path, see out_node().
+     */
+    ArenaVector<std::string> labels;
+    ArenaMap<std::string, bool*> indicatorps;
     bool *indicators;
-    std::map<bool*, unsigned long> nodecounts;
+    ArenaMap<bool*, unsigned long> nodecounts;
 
 
     /*
@@ -36,7 +51,7 @@ typedef struct __graph {
      * IF NODE IS NOT IN GRAPH ITS BOOLEAN VALUE IS FALSE.
      *
      * */
-    std::map<bool*, neighbour_map_value> neighbours;
+    ArenaMap<bool*, neighbour_map_value> neighbours;
 
     /*
      * node_degree_map takes a certain degree as a key and
@@ -48,14 +63,21 @@ typedef struct __graph {
      * IT DOES NOT KEEP TRACK OF EVERY NODES DEGREE.
      *
      * */
-    std::map<unsigned long, std::set<bool*>> node_degree_map;
+    ArenaMap<unsigned long, NodeSet> node_degree_map;
 
     /*
      * L & R are sets of nodes in case the graph is bipartite
      */
 
-    std::set<bool*> L;
-    std::set<bool*> R;
+    NodeSet L;
+    NodeSet R;
+
+    /*
+     * Nodes with a self-loop. They are in every vertex cover.
+     * Self-loops and parallel edges are not stored as edges,
+     * so degrees are always the real number of distinct neighbours.
+     */
+    ArenaVector<bool*> forced;
 
 } Graph;
 
@@ -94,21 +116,31 @@ void delete_node_erase(bool* node, Graph* graph);
  */
 void undelete_node_insert(bool* node, Graph* graph);
 
-std::set<bool*> get_node_neighbours(bool* node, Graph* graph);
+const NodeSet& get_node_neighbours(bool* node, Graph* graph);
 
 unsigned long get_node_degree(bool* node, Graph* graph);
 
 void print_graph(Graph* graph);
 
 
+/*
+ * Creates an empty graph inside the given arena.
+ * The graph owns the arena from now on.
+ */
+Graph* new_graph(Arena* arena);
 
+/*
+ * Runs the destructor of the graph (it frees label strings, which
+ * keep long bodies on the heap), then frees its arena at once.
+ * The graph pointer is invalid afterwards.
+ */
 void delete_graph(Graph* graph);
 
 unsigned long get_m(Graph* graph);
 
 // void set_m(unsigned long);
 
-std::map<bool*, unsigned long>* get_nodecounts(Graph* graph);
+ArenaMap<bool*, unsigned long>* get_nodecounts(Graph* graph);
 
 Edge* get_last_first_edge_position(Graph* graph);
 
@@ -118,7 +150,22 @@ Edge* get_first_edge(Graph* graph);
 
 void print_edge_array(Graph* graph);
 
-Graph readin();
+/*
+ * Numeric id of a node: its index into graph->indicators and graph->labels.
+ */
+unsigned long node_id(bool* node, Graph* graph);
+
+/*
+ * Writes the label of node id into out. No map lookup.
+ */
+void out_node(Out* out, unsigned long id, Graph* graph);
+
+/*
+ * Reads a graph in the "n m" + label pair format.
+ * Parallel edges are dropped, self-loops go into graph->forced.
+ * Defaults to stdin. The benchmark passes in-memory streams.
+ */
+Graph* readin(std::istream& in = std::cin);
 
 
 #endif //PP_AE_VC_GRAPH_H
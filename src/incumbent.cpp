@@ -0,0 +1,36 @@
+#include "incumbent.h"
+
+#include "trace.h"
+
+
+bool incumbent_offer(Incumbent* incumbent, const std::vector<uint32_t>& cover) {
+    unsigned long size = incumbent->best_size.load(std::memory_order_acquire);
+    do {
+        if (cover.size() >= size) return false;
+    } while (!incumbent->best_size.compare_exchange_weak(size, cover.size(), std::memory_order_acq_rel));
+
+    {
+        // only improvements get here, so the lock is rarely contended
+        std::lock_guard<std::mutex> guard(incumbent->lock);
+        // a smaller cover may have been stored since our CAS
+        if (!incumbent->has_best || cover.size() < incumbent->best.size()) {
+            incumbent->best = cover;
+            incumbent->has_best = true;
+        }
+    }
+    if (incumbent->phase) trace_record(cover.size(), incumbent_lower_bound(incumbent), incumbent->phase);
+    return true;
+}
+
+
+void incumbent_raise_lower_bound(Incumbent* incumbent, unsigned long lb) {
+    unsigned long current = incumbent->lower_bound.load(std::memory_order_acquire);
+    while (current < lb && !incumbent->lower_bound.compare_exchange_weak(current, lb, std::memory_order_acq_rel)) {}
+    if (current < lb && incumbent->phase) trace_record(incumbent_size(incumbent), lb, incumbent->phase);
+}
+
+
+std::vector<uint32_t> incumbent_cover(Incumbent* incumbent) {
+    std::lock_guard<std::mutex> guard(incumbent->lock);
+    return incumbent->best;
+}
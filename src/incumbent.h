@@ -0,0 +1,65 @@
+/*
+ *
+ * Best known cover and lower bound, shared by parallel workers.
+ * best_size and lower_bound are atomics, pruning only loads them.
+ * An improvement first wins a CAS on best_size, then its cover is
+ * copied into best under a mutex. Only improvements and
+ * incumbent_cover() (once per solve) take the mutex, pruning never
+ * touches it.
+ *
+ */
+
+#ifndef PP_AE_VC_INCUMBENT_H
+#define PP_AE_VC_INCUMBENT_H
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+
+typedef struct __incumbent {
+    std::atomic<unsigned long> best_size{ULONG_MAX};
+    std::atomic<unsigned long> lower_bound{0};
+    std::mutex lock;                 // guards best and has_best
+    std::vector<uint32_t> best;
+    bool has_best = false;           // best holds a cover, the empty one included
+    const char* phase = nullptr;   // if set, improvements are traced as this phase (trace.h)
+} Incumbent;
+
+
+inline unsigned long incumbent_size(const Incumbent* incumbent) {
+    return incumbent->best_size.load(std::memory_order_acquire);
+}
+
+inline unsigned long incumbent_lower_bound(const Incumbent* incumbent) {
+    return incumbent->lower_bound.load(std::memory_order_acquire);
+}
+
+/*
+ * Publishes cover if it is smaller than the best one.
+ * Returns true if it was.
+ */
+bool incumbent_offer(Incumbent* incumbent, const std::vector<uint32_t>& cover);
+
+/*
+ * Raises the shared lower bound to at least lb.
+ */
+void incumbent_raise_lower_bound(Incumbent* incumbent, unsigned long lb);
+
+/*
+ * True once the best cover meets the lower bound, workers can stop.
+ */
+inline bool incumbent_optimal(const Incumbent* incumbent) {
+    return incumbent_size(incumbent) <= incumbent_lower_bound(incumbent);
+}
+
+/*
+ * Copy of the best cover. Empty if nothing was offered yet, which
+ * best_size == ULONG_MAX tells apart from an empty cover.
+ */
+std::vector<uint32_t> incumbent_cover(Incumbent* incumbent);
+
+
+#endif //PP_AE_VC_INCUMBENT_H
@@ -1,5 +1,6 @@
 #include "lb.h"
 #include "graph.h"
+#include "stats.h"
 
 #include <iostream>
 #include <fstream>
@@ -15,27 +16,36 @@
 
 
 unsigned long basic_lb(Graph* graph) {
+    if (get_nodecounts(graph)->empty()) return 0;
     auto max_degree_node = std::max_element(
             get_nodecounts(graph)->begin(), get_nodecounts(graph)->end(),
             [](const auto &a, const auto &b) {
                 return a.second < b.second;
             }
     );
-    return get_m(graph) / max_degree_node->second;
+    if (max_degree_node->second == 0) return 0;
+    // every node covers at most max degree edges, rounded up
+    return (get_m(graph) + max_degree_node->second - 1) / max_degree_node->second;
 }
 
 
 // Function to convert a regular graph to a bipartite graph
-Graph graphToBipartite(Graph* graph) {
-    Graph bipartiteGraph = Graph();
-    bipartiteGraph.edges = new Edge[2*graph->m];
-    bipartiteGraph.indicators = new bool[4*graph->m];
+// The bipartite graph is allocated in the given arena.
+// Edges past the deadline are left out, a matching of the partial graph
+// is still one of the full graph.
+Graph* graphToBipartite(Graph* graph, Arena* arena, Deadline deadline) {
+    Graph& bipartiteGraph = *new_graph(arena);
+    bipartiteGraph.edges = arena_new_array<Edge>(arena, 2*graph->m);
+    bipartiteGraph.indicators = arena_new_array<bool>(arena, 4*graph->m);
+    unsigned long indicatorindex = 0;
 
     // Create left and right partitions
     for (const auto& node : graph->strings) {
         if (*graph->indicatorps[node.second]) {
-            bool *leftNode = new bool(true);
-            bool *rightNode = new bool(true);
+            bool *leftNode = &bipartiteGraph.indicators[indicatorindex++];
+            bool *rightNode = &bipartiteGraph.indicators[indicatorindex++];
+            *leftNode = true;
+            *rightNode = true;
 
             bipartiteGraph.L.insert(leftNode);
             bipartiteGraph.R.insert(rightNode);
@@ -46,13 +56,14 @@ Graph graphToBipartite(Graph* graph) {
             bipartiteGraph.indicatorps[graph->strings[node.first] + "_L"] = leftNode;
             bipartiteGraph.indicatorps[graph->strings[node.first] + "_R"] = rightNode;
 
-            bipartiteGraph.neighbours[leftNode] = std::make_tuple(0, std::set<bool*>());
-            bipartiteGraph.neighbours[rightNode] = std::make_tuple(0, std::set<bool*>());
+            bipartiteGraph.neighbours[leftNode] = std::make_tuple(0, NodeSet());
+            bipartiteGraph.neighbours[rightNode] = std::make_tuple(0, NodeSet());
         }
     }
 
     // Create edges in the bipartite graph
     for (unsigned long i = 0; i < graph->m; ++i) {
+        if (i % 1024 == 1023 && std::chrono::steady_clock::now() >= deadline) break;
         if ( std::get<0>(graph->edges[i]) && std::get<1>(graph->edges[i]) ) {
             bool* leftNode = bipartiteGraph.indicatorps[graph->strings[std::get<0>(graph->edges[i])] + "_L"];
             bool* rightNode = bipartiteGraph.indicatorps[graph->strings[std::get<1>(graph->edges[i])] + "_R"];
@@ -99,11 +110,11 @@ Graph graphToBipartite(Graph* graph) {
         }
     }
 
-    return bipartiteGraph;
+    return &bipartiteGraph;
 }
 
 
-void bfs(Graph* graph, std::map<bool*, bool*>& matching, std::map<bool*, int>& dist) {
+void bfs(Graph* graph, ArenaMap<bool*, bool*>& matching, ArenaMap<bool*, int>& dist) {
     std::deque<bool*> queue;
 
     for (bool* u : graph->L) {
@@ -133,7 +144,7 @@ void bfs(Graph* graph, std::map<bool*, bool*>& matching, std::map<bool*, int>& d
 }
 
 // Function to perform DFS
-bool dfs(bool* u, Graph* graph, std::map<bool*, bool*>& matching, std::map<bool*, int>& dist) {
+bool dfs(bool* u, Graph* graph, ArenaMap<bool*, bool*>& matching, ArenaMap<bool*, int>& dist) {
     if (u != nullptr) {
         for (bool* v : get_node_neighbours(u, graph)) {
             if (dist[matching[v]] == dist[u] + 1 && dfs(matching[v], graph, matching, dist)) {
@@ -149,9 +160,9 @@ bool dfs(bool* u, Graph* graph, std::map<bool*, bool*>& matching, std::map<bool*
 }
 
 // Hopcroft-Karp algorithm
-std::map<bool*, bool*> hopcroft_karp(Graph* graph) {
-    std::map<bool*, bool*> matching;
-    std::map<bool*, int> dist;
+ArenaMap<bool*, bool*> hopcroft_karp(Graph* graph, Deadline deadline) {
+    ArenaMap<bool*, bool*> matching;
+    ArenaMap<bool*, int> dist;
 
     for (bool* u : graph->L) {
         matching[u] = nullptr;
@@ -160,18 +171,28 @@ std::map<bool*, bool*> hopcroft_karp(Graph* graph) {
     while (true) {
         bfs(graph, matching, dist);
         bool augmenting_paths_found = false;
+        bool expired = false;
+        unsigned long paths = 0;
+        unsigned long tried = 0;
 
         for (bool* u : graph->L) {
+            // the first phase alone can take seconds, so also check within it
+            if (++tried % 256 == 0 && std::chrono::steady_clock::now() >= deadline) {
+                expired = true;
+                break;
+            }
             if (matching[u] == nullptr && dfs(u, graph, matching, dist)) {
                 augmenting_paths_found = true;
+                paths++;
             }
         }
+        STATS_PUSH(hk_paths, paths);
 
-        if (!augmenting_paths_found) {
+        if (!augmenting_paths_found || expired || std::chrono::steady_clock::now() >= deadline) {
             break;
         }
     }
-    std::map<bool*, bool*> valid_matching;
+    ArenaMap<bool*, bool*> valid_matching;
 
     // Copy valid entries to the new map
     for (const auto& entry : matching) {
@@ -182,7 +203,7 @@ std::map<bool*, bool*> hopcroft_karp(Graph* graph) {
     return valid_matching;
 }
 
-void print_match(Graph* graph, std::map<bool*, bool*> matching){
+void print_match(Graph* graph, ArenaMap<bool*, bool*> matching){
     // Print the matching result (for testing)
     std::cout << "Matching Result:" << std::endl;
     for (const auto& entry : matching) {
@@ -190,16 +211,28 @@ void print_match(Graph* graph, std::map<bool*, bool*> matching){
     }
 }
 
-unsigned long lpb(Graph* graph) {
-    Graph _bp = graphToBipartite(graph);
-    Graph* bp = &_bp;
-    std::map<bool*, bool*> matching = hopcroft_karp(bp);
-//    print_match(bp, matching);
-    return matching.size()/4;
+unsigned long lpb(Graph* graph, Deadline deadline) {
+    STATS_TIMER(PHASE_LP_LB);
+    Arena* scratch = scratch_arena();
+    unsigned long size;
+    {
+        ArenaScope scope(scratch);
+        Graph* bp = graphToBipartite(graph, scratch, deadline);
+        ArenaMap<bool*, bool*> matching = hopcroft_karp(bp, deadline);
+//        print_match(bp, matching);
+        size = matching.size();
+        // frees the heap bodies of the "_L" / "_R" labels
+        bp->~Graph();
+    }
+    // bipartite graph and matching were temporaries
+    arena_reset(scratch);
+    // size counts both directions, the lp optimum is half the bipartite matching.
+    // A cover has integer size, so the lp value rounds up.
+    return (size + 3) / 4;
 }
 
 
-void intersection(std::set<bool*>* set1, std::set<bool*>* set2) {
+void intersection(NodeSet* set1, NodeSet* set2) {
     /// results are written into set1!
     auto it = set1->begin();
     while (it != set1->end()) {
@@ -217,7 +250,7 @@ unsigned long clique_value(bool* node, Graph* graph) {
     unsigned long min_clique_size = 3;
     unsigned long lb = 0;
 
-    std::set<bool*> clique;
+    NodeSet clique;
     clique.insert(node);
     clique.insert(std::get<1>(graph->neighbours[node]).begin(), std::get<1>(graph->neighbours[node]).end());
     //print_vertex_set(clique, graph);
@@ -240,18 +273,27 @@ unsigned long clique_value(bool* node, Graph* graph) {
         for (auto &it: clique) {
             delete_node_erase(it, graph);
         }
+        STATS_ADD(deleted_clique, clique.size());
     }
     return lb;
 }
 
 
-unsigned long clique_cover_lb(Graph* graph) {
+unsigned long clique_cover_lb(Graph* graph, Deadline deadline) {
+    STATS_TIMER(PHASE_CLIQUE_LB);
     unsigned long lower_bound = 0;
+    unsigned long visited = 0;
 
     for (const auto &node: graph->neighbours) {
         if (!*node.first) continue;
+        // the cliques found so far are disjoint, their bound holds as is
+        if (++visited % 64 == 0 && std::chrono::steady_clock::now() >= deadline) break;
         //std::cout << graph->strings[node.first] << std::endl;
-        lower_bound += clique_value(node.first, graph);
+        {
+            ArenaScope scope(scratch_arena());
+            lower_bound += clique_value(node.first, graph);
+        }
+        arena_reset(scratch_arena());
         //std::cout << lower_bound << std::endl;
     }
 
@@ -260,7 +302,7 @@ unsigned long clique_cover_lb(Graph* graph) {
 
 
 
-void push_neighbours_on_queue(std::queue<bool*>* queue, const std::set<bool*>& neighbours, bool* parent, std::map<bool*, bool*>* parents, std::set<bool*>* looked_at) {
+void push_neighbours_on_queue(std::queue<bool*>* queue, const NodeSet& neighbours, bool* parent, ArenaMap<bool*, bool*>* parents, NodeSet* looked_at) {
     for (bool* it: neighbours) {
         if (looked_at->find(it) != looked_at->end()) continue;
         if (!*it) continue;
@@ -270,25 +312,27 @@ void push_neighbours_on_queue(std::queue<bool*>* queue, const std::set<bool*>& n
 }
 
 
-unsigned long handle_found_circle(bool* root, std::map<bool*, bool*> parents, Graph* graph) {
+unsigned long handle_found_circle(bool* root, ArenaMap<bool*, bool*> parents, Graph* graph) {
     unsigned long size = 1; // one for the root
     bool* temp = parents[root];
     while (temp != root) {
         size++;
         delete_node_erase(temp, graph);
+        STATS_INC(deleted_cycle);
         temp = parents[temp];
     }
     delete_node_erase(root, graph);
+    STATS_INC(deleted_cycle);
     return std::ceil(size / 2);
 }
 
 
-unsigned long find_cycle(bool* root, std::set<bool*> looked_at, Graph* graph) {
+unsigned long find_cycle(bool* root, NodeSet looked_at, Graph* graph) {
     if (std::get<0>(graph->neighbours[root]) < 2) return 0;
     if (looked_at.find(root) != looked_at.end()) return 0;
 
-    std::map<bool*, bool*> parents; // stores parent node.
-    std::set<bool*> nodes_in_path;
+    ArenaMap<bool*, bool*> parents; // stores parent node.
+    NodeSet nodes_in_path;
     nodes_in_path.insert(root);
 
     std::queue<bool*> waiting;
@@ -318,22 +362,27 @@ unsigned long find_cycle(bool* root, std::set<bool*> looked_at, Graph* graph) {
 }
 
 
-unsigned long cycle_bound(Graph* graph) {
+unsigned long cycle_bound(Graph* graph, Deadline deadline) {
+    STATS_TIMER(PHASE_CYCLE_LB);
     auto start_time = std::chrono::high_resolution_clock::now();
     unsigned long lb = 0;
-    std::set<bool*> looked_at;
+    NodeSet looked_at;
 
     auto it = graph->neighbours.begin();
     while (it != graph->neighbours.end()) {
 
         auto cur_time = std::chrono::high_resolution_clock::now();
         auto e_t = std::chrono::duration_cast<std::chrono::seconds>(cur_time - start_time);
-        if (e_t >= std::chrono::seconds(30)) return lb;
+        if (e_t >= std::chrono::seconds(30) || std::chrono::steady_clock::now() >= deadline) return lb;
 
         if (!*it->first) {}
         else if (looked_at.find(it->first) != looked_at.end()) {}
         else {
-            lb += find_cycle(it->first, looked_at, graph);
+            {
+                ArenaScope scope(scratch_arena());
+                lb += find_cycle(it->first, looked_at, graph);
+            }
+            arena_reset(scratch_arena());
             looked_at.insert(it->first);
         }
         ++it;
@@ -13,15 +13,24 @@
 
 
 
+#include <chrono>
+
 #include "graph.h"
 
+typedef std::chrono::steady_clock::time_point Deadline;
+
+/*
+ * The bounds below stop at the deadline and return what they have so
+ * far, which is still a valid (weaker) lower bound.
+ */
+
 /*
  * Compute a clique cover lower bound.
  * Removes most cliques from the given Graph.
  * Uses the delete_node_erase function!
  * Returns the lb value after removing the cliques.
  */
-unsigned long clique_cover_lb(Graph*);
+unsigned long clique_cover_lb(Graph*, Deadline deadline = Deadline::max());
 
 /*
  * Compute a cycle cover lower bound.
@@ -31,13 +40,16 @@ unsigned long clique_cover_lb(Graph*);
  * Uses the delete_node_erase function!
  * Returns the lb value after removing the cycles.
  */
-unsigned long cycle_bound(Graph*);
+unsigned long cycle_bound(Graph*, Deadline deadline = Deadline::max());
 
 /*
  * Compute lp bound of a graph.
+ * The deadline is checked between Hopcroft-Karp phases and every 256
+ * vertices within one, a partial matching still bounds the lp optimum
+ * from below.
  * returns the size of the lp bound.
  */
-unsigned long lpb(Graph*);
+unsigned long lpb(Graph*, Deadline deadline = Deadline::max());
 
 /*
  * Compute a very basic lower bound.
@@ -14,42 +14,57 @@
 #include "lb.h"
 #include "dr.h"
 #include "ub.h"
-
-
-
-
-std::stack<bool*>* resstack = new std::stack<bool*>; // stack to store final vertex cover
+#include "out.h"
+#include "stats.h"
+#include "csr.h"
+#include "pipeline.h"
+#include "batch.h"
+#include "stream.h"
+#include "trace.h"
 
 
 
 void printnodestack(std::stack<bool*>* stck, Graph* graph) {
+    STATS_TIMER(PHASE_OUTPUT);
     bool* node;
+    Out out;
+    out_open(&out);
     while (!stck->empty()) {
         node = stck->top();
         stck->pop();
-        std::cout << graph->strings[node] << std::endl;
+        out_node(&out, node_id(node, graph), graph);
+        out_char(&out, '\n');
     }
+    out_close(&out);
 }
 
 
 void print_solution_graph(Graph* graph) {
+    Out out;
+    out_open(&out);
     for (const auto& node: graph->neighbours) {
         if (*node.first) {
-            std::cout << graph->strings[node.first] << std::endl;
+            out_node(&out, node_id(node.first, graph), graph);
+            out_char(&out, '\n');
         }
     }
+    out_close(&out);
 }
 
 
-void print_node_set_with_deleted(std::set<bool*> s, Graph* graph) {
+void print_node_set_with_deleted(const NodeSet& s, Graph* graph) {
+    Out out;
+    out_open(&out);
     for (bool* node: s) {
-        std::cout << graph->strings[node] << std::endl;
+        out_node(&out, node_id(node, graph), graph);
+        out_char(&out, '\n');
     }
+    out_close(&out);
 }
 
 
 
-void print_vertex_set(std::set<bool*> s, Graph* graph) {
+void print_vertex_set(const NodeSet& s, Graph* graph) {
     for (const auto &b: s) {
         std::cout << graph->strings[b] << " ";
     }
@@ -59,25 +74,202 @@ void print_vertex_set(std::set<bool*> s, Graph* graph) {
 
 
 
-int main() {
-    Graph _graph = readin();
-    Graph* graph = &_graph;
+void print_labels(const std::vector<std::string>& labels, const std::vector<uint32_t>& cover) {
+    STATS_TIMER(PHASE_OUTPUT);
+    Out out;
+    out_open(&out);
+    for (uint32_t v: cover) {
+        out_string(&out, labels[v]);
+        out_char(&out, '\n');
+    }
+    out_close(&out);
+}
 
-    unsigned long lb = 0;
 
+/*
+ * Prints forced nodes of graph and a cover of the kernel (kernel ids).
+ */
+void print_cover(std::stack<bool*>* forced, Graph* graph, const std::vector<uint32_t>& cover, const Csr* kernel) {
+    printnodestack(forced, graph);
+    print_labels(kernel->labels, cover);
+}
 
-    std::stack<bool*> res_stack;
-    deg_one(graph, &res_stack);
-    max_deg_heur(graph, &res_stack);
 
+int run_ub(const Options* options, Rng* rng) {
+    Graph* graph;
+    {
+        Csr csr = load_csr(options);
+        if (options->ub == "matching" || std::chrono::steady_clock::now() >= options->deadline) {
+            // fallback, the 2-approximation the reader built while parsing
+            std::vector<uint32_t> cover = ub_read_matching(&csr);
+            trace_record(cover.size(), csr.forced.size() + csr.matching.size() / 2, "matching");
+            print_labels(csr.labels, cover);
+            return 0;
+        }
+        if (packed_ub_preferred(&csr, options)) {
+            // large input: never build the Graph
+            print_labels(csr.labels, packed_upper_bound(&csr, options));
+            return 0;
+        }
+        graph = graph_from_csr(&csr);
+    }
+    std::stack<bool*> res_stack;
+    run_reductions(graph, options, &res_stack);
+    run_upper_bound(graph, options, &res_stack, rng);
     printnodestack(&res_stack, graph);
+    delete_graph(graph);
+    return 0;
+}
+
+
+/*
+ * Reads the graph and runs the reductions. The reader's matching bound
+ * (on the input graph) goes into account once the offset is known.
+ */
+Graph* load_reduced(const Options* options, std::stack<bool*>* res_stack, BoundAccount* account) {
+    Graph* graph;
+    unsigned long matching_lb;
+    {
+        Csr csr = load_csr(options);
+        matching_lb = csr.forced.size() + csr.matching.size() / 2;
+        graph = graph_from_csr(&csr);
+    }
+    run_reductions(graph, options, res_stack, account);
+    account_raise_total(account, matching_lb);
+    return graph;
+}
+
+
+int run_lb(const Options* options) {
+    std::stack<bool*> res_stack;
+    BoundAccount account;
+    Graph* graph = load_reduced(options, &res_stack, &account);
+    Csr kernel = csr_from_graph(graph);
+    delete_graph(graph);
+
+    std::cout << run_lower_bound(&kernel, options, &account) << std::endl;
+    if (options->stats) {
+        std::cerr << "lb forced=" << account.forced << " reduced=" << account.reduced
+                  << " kernel=" << account.kernel << " total=" << account_total(&account) << std::endl;
+    }
+    return 0;
+}
+
+
+int run_exact_mode(const Options* options, Rng* rng) {
+    std::stack<bool*> res_stack;
+    BoundAccount account;
+    Graph* graph = load_reduced(options, &res_stack, &account);
+    Csr kernel = csr_from_graph(graph);
 
-    /// only for development purposes
-    /// REMOVE BEFORE SUBMISSION
-    // std::cout << s << std::endl;
+    bool optimal = false;
+    std::vector<uint32_t> cover = run_exact(&kernel, options, rng, &optimal, &account);
+    if (!optimal) {
+        // a cover that is not proven optimal is a wrong answer for the
+        // checker, a missing one only a time limit
+        std::cerr << "exact: time limit reached before the cover was proven optimal" << std::endl;
+        delete_graph(graph);
+        return 2;
+    }
+    print_cover(&res_stack, graph, cover, &kernel);
+    delete_graph(graph);
+    return 0;
+}
 
 
+int run_kernel(const Options* options) {
+    Graph* graph = load_graph(options);
+    std::stack<bool*> res_stack;
+    unsigned long forced = run_reductions(graph, options, &res_stack);
+    print_edge_array(graph);
+    std::cout << "#difference: " << forced << std::endl;
+    delete_graph(graph);
+    return 0;
+}
+
+
+/*
+ * Input is the original graph, the kernel and a cover of the kernel:
+ * #InputGraph, #KernelGraph and #StartSolution sections.
+ * The reductions are deterministic, running them again on the input
+ * graph gives the same forced nodes as in kernel mode.
+ */
+int run_lift(const Options* options) {
+    std::string input;
+    std::vector<std::string> solution;
+    std::string section;
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        if (line.compare(0, 11, "#InputGraph") == 0) section = "input";
+        else if (line.compare(0, 12, "#KernelGraph") == 0) section = "kernel";
+        else if (line.compare(0, 14, "#StartSolution") == 0) section = "solution";
+        else if (section == "input") input += line + "\n";
+        else if (section == "solution") {
+            std::string label = line.substr(0, line.find('#'));
+            std::istringstream stream(label);
+            if (stream >> label) solution.push_back(label);
+        }
+    }
+
+    Graph* graph = load_graph(input, options);
+    std::stack<bool*> res_stack;
+    run_reductions(graph, options, &res_stack);
+    printnodestack(&res_stack, graph);
     delete_graph(graph);
 
+    Out out;
+    out_open(&out);
+    for (const auto& label: solution) {
+        out_string(&out, label);
+        out_char(&out, '\n');
+    }
+    out_close(&out);
+    return 0;
+}
+
+
+/*
+ * Never builds the graph: edges are spooled to disk and streamed, see stream.h.
+ */
+int run_stream(const Options* options) {
+    StreamResult result;
+    if (!stream_cover(0, options->stream_passes, options->kernel_out, &result)) {
+        std::cerr << "stream: spool or kernel file failed, no valid cover" << std::endl;
+        return 1;
+    }
+    print_labels(result.labels, result.cover);
+    if (options->stats) std::cerr << "stream n=" << result.n << " m=" << result.m << " passes=" << result.passes
+              << " matching_lb=" << result.matching << " fixed=" << result.taken
+              << " kernel_n=" << result.kernel_n << " kernel_m=" << result.kernel_m
+              << " cover=" << result.cover.size() << std::endl;
     return 0;
-}
\ No newline at end of file
+}
+
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_options(argc, argv, &options)) return 1;
+
+    if (options.ub == "rand" && !options.seeded) {
+        // report it, so a good run can be reproduced with --seed
+        options.seed = rng_random_seed();
+        std::cerr << "seed " << options.seed << std::endl;
+    }
+    Rng rng;
+    rng_seed(&rng, options.seed);
+    if (!options.trace.empty()) trace_open();
+
+    int ret = 0;
+    if (!options.batch.empty()) ret = run_batch(&options);
+    else if (options.mode == "ub") ret = run_ub(&options, &rng);
+    else if (options.mode == "lb") ret = run_lb(&options);
+    else if (options.mode == "exact") ret = run_exact_mode(&options, &rng);
+    else if (options.mode == "kernel") ret = run_kernel(&options);
+    else if (options.mode == "lift") ret = run_lift(&options);
+    else if (options.mode == "stream") ret = run_stream(&options);
+
+    if (options.stats) stats_print(std::cerr);
+    if (!trace_dump(options.trace)) std::cerr << "can not write trace " << options.trace << std::endl;
+
+    return ret;
+}
@@ -0,0 +1,89 @@
+/*
+ *
+ * Csr with the narrowest index type that fits.
+ * Csr stores uint64 offsets and uint32 neighbours for every graph, but
+ * most kernels of vc1 and vc2 have fewer than 2^16 nodes and entries.
+ * NarrowCsr<Index> stores offsets and neighbours as Index, so the
+ * arrays the hot loops scan over and over take a half (uint32) or a
+ * quarter (uint16) of the cache.
+ *
+ * with_index_width() is the one place that picks the width from n and
+ * m: NarrowCsr<uint16_t>, NarrowCsr<uint32_t>, or the Csr itself (64 bit
+ * offsets). Algorithms written against for_each_neighbour() and
+ * degree_of() (see packed.h) run on all three.
+ *
+ */
+
+#ifndef PP_AE_VC_NARROW_H
+#define PP_AE_VC_NARROW_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "csr.h"
+
+
+template<typename Index>
+struct NarrowCsr {
+    unsigned long n = 0;
+    unsigned long m = 0;
+    std::vector<Index> offsets;
+    std::vector<Index> adj;
+};
+
+
+template<typename Index>
+inline unsigned long degree_of(const NarrowCsr<Index>* g, uint32_t v) {
+    return g->offsets[v + 1] - g->offsets[v];
+}
+
+template<typename Index, typename F>
+inline bool for_each_neighbour(const NarrowCsr<Index>* g, uint32_t v, F f) {
+    const Index* p = g->adj.data() + g->offsets[v];
+    const Index* end = g->adj.data() + g->offsets[v + 1];
+    for (; p < end; p++) {
+        if (!f((uint32_t) *p)) return false;
+    }
+    return true;
+}
+
+
+/*
+ * True if ids (< n) and offsets (<= 2m) of csr fit into Index.
+ */
+template<typename Index>
+inline bool index_fits(const Csr* csr) {
+    return csr->n <= std::numeric_limits<Index>::max() && csr->adj.size() <= std::numeric_limits<Index>::max();
+}
+
+template<typename Index>
+NarrowCsr<Index> narrow_csr(const Csr* csr) {
+    NarrowCsr<Index> g;
+    g.n = csr->n;
+    g.m = csr->m;
+    g.offsets.assign(csr->offsets.begin(), csr->offsets.end());
+    g.adj.assign(csr->adj.begin(), csr->adj.end());
+    return g;
+}
+
+
+/*
+ * Calls f with the narrowest form of csr and returns its result.
+ * f is instantiated for all three types, a generic lambda is easiest.
+ */
+template<typename F>
+auto with_index_width(const Csr* csr, F f) -> decltype(f(csr)) {
+    if (index_fits<uint16_t>(csr)) {
+        NarrowCsr<uint16_t> g = narrow_csr<uint16_t>(csr);
+        return f(&g);
+    }
+    if (index_fits<uint32_t>(csr)) {
+        NarrowCsr<uint32_t> g = narrow_csr<uint32_t>(csr);
+        return f(&g);
+    }
+    return f(csr);
+}
+
+
+#endif //PP_AE_VC_NARROW_H
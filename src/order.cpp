@@ -0,0 +1,99 @@
+#include "order.h"
+#include "core.h"
+
+#include <algorithm>
+
+
+std::vector<uint32_t> order_degeneracy(const Csr* csr) {
+    return core_decomposition(csr).order;
+}
+
+
+/*
+ * Bfs over all components. Roots are taken by ascending degree.
+ * If by_degree, the neighbours of a node are visited by ascending degree.
+ */
+static std::vector<uint32_t> bfs_order(const Csr* csr, bool by_degree) {
+    unsigned long n = csr->n;
+    std::vector<uint32_t> roots(n);
+    for (uint32_t v = 0; v < n; v++) roots[v] = v;
+    std::stable_sort(roots.begin(), roots.end(), [csr](uint32_t a, uint32_t b) {
+        return csr_degree(csr, a) < csr_degree(csr, b);
+    });
+
+    std::vector<uint32_t> order;
+    order.reserve(n);
+    std::vector<char> seen(n, 0);
+    std::vector<uint32_t> next;
+    for (uint32_t root: roots) {
+        if (seen[root]) continue;
+        seen[root] = 1;
+        unsigned long head = order.size();
+        order.push_back(root);
+        while (head < order.size()) {
+            uint32_t v = order[head++];
+            next.clear();
+            for (uint64_t j = csr->offsets[v]; j < csr->offsets[v + 1]; j++) {
+                uint32_t u = csr->adj[j];
+                if (seen[u]) continue;
+                seen[u] = 1;
+                next.push_back(u);
+            }
+            if (by_degree) {
+                std::stable_sort(next.begin(), next.end(), [csr](uint32_t a, uint32_t b) {
+                    return csr_degree(csr, a) < csr_degree(csr, b);
+                });
+            }
+            order.insert(order.end(), next.begin(), next.end());
+        }
+    }
+    return order;
+}
+
+
+std::vector<uint32_t> order_bfs(const Csr* csr) {
+    return bfs_order(csr, false);
+}
+
+
+std::vector<uint32_t> order_rcm(const Csr* csr) {
+    std::vector<uint32_t> order = bfs_order(csr, true);
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+
+void csr_permute(Csr* csr, const std::vector<uint32_t>& order) {
+    unsigned long n = csr->n;
+    std::vector<uint32_t> new_id(n);
+    for (uint32_t i = 0; i < n; i++) new_id[order[i]] = i;
+
+    std::vector<uint64_t> offsets(n + 1, 0);
+    std::vector<uint32_t> adj(csr->adj.size());
+    std::vector<std::string> labels(n);
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t v = order[i];
+        offsets[i + 1] = offsets[i] + csr_degree(csr, v);
+        auto out = adj.begin() + offsets[i];
+        for (uint64_t j = csr->offsets[v]; j < csr->offsets[v + 1]; j++) *out++ = new_id[csr->adj[j]];
+        std::sort(adj.begin() + offsets[i], out);
+        labels[i] = std::move(csr->labels[v]);
+    }
+    for (uint32_t& v: csr->forced) v = new_id[v];
+    std::sort(csr->forced.begin(), csr->forced.end());
+    for (uint32_t& v: csr->matching) v = new_id[v];
+
+    csr->offsets.swap(offsets);
+    csr->adj.swap(adj);
+    csr->labels.swap(labels);
+}
+
+
+bool csr_reorder(Csr* csr, const std::string& ordering) {
+    if (ordering == "none") return true;
+    if (ordering == "degeneracy") csr_permute(csr, order_degeneracy(csr));
+    else if (ordering == "bfs") csr_permute(csr, order_bfs(csr));
+    else if (ordering == "rcm") csr_permute(csr, order_rcm(csr));
+    else return false;
+    return true;
+}
@@ -0,0 +1,48 @@
+/*
+ *
+ * Vertex reordering for cache locality.
+ * The input order of labels is arbitrary, so neighbours of a node are
+ * spread over all of memory. Relabeling the Csr after loading puts
+ * nodes that are accessed together next to each other.
+ *
+ * Orderings:
+ * - none:       input order
+ * - degeneracy: nodes in the order a min degree peeling removes them
+ * - bfs:        breadth first search order, component by component
+ * - rcm:        reverse Cuthill-McKee, bfs with neighbours by ascending
+ *               degree, reversed. Small bandwidth.
+ *
+ */
+
+#ifndef PP_AE_VC_ORDER_H
+#define PP_AE_VC_ORDER_H
+
+#include <string>
+#include <vector>
+
+#include "csr.h"
+
+
+/*
+ * order[i] is the old id of the node that gets the new id i.
+ */
+std::vector<uint32_t> order_degeneracy(const Csr* csr);
+
+std::vector<uint32_t> order_bfs(const Csr* csr);
+
+std::vector<uint32_t> order_rcm(const Csr* csr);
+
+/*
+ * Relabels csr: new id i is old id order[i].
+ * Adjacency, labels and forced nodes are permuted, so the output
+ * still prints the input labels without any extra lookup.
+ */
+void csr_permute(Csr* csr, const std::vector<uint32_t>& order);
+
+/*
+ * Applies the ordering with the given name. Returns false for unknown names.
+ */
+bool csr_reorder(Csr* csr, const std::string& ordering);
+
+
+#endif //PP_AE_VC_ORDER_H
@@ -0,0 +1,77 @@
+#include "out.h"
+
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+
+
+// one chunk. a vc3 cover fits into a single write.
+static const unsigned long OUT_CHUNK = 1 << 16;
+
+
+void out_open(Out* out, int fd) {
+    std::cout.flush();
+    out->fd = fd;
+    out->buf = new char[OUT_CHUNK];
+    out->pos = 0;
+    out->cap = OUT_CHUNK;
+    out->failed = false;
+}
+
+
+void out_flush(Out* out) {
+    unsigned long done = 0;
+    while (done < out->pos) {
+        ssize_t w = write(out->fd, out->buf + done, out->pos - done);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            out->failed = true;
+            break;
+        }
+        done += w;
+    }
+    out->pos = 0;
+}
+
+
+void out_close(Out* out) {
+    out_flush(out);
+    delete[] out->buf;
+    out->buf = nullptr;
+    out->cap = 0;
+}
+
+
+void out_str(Out* out, const char* s, unsigned long len) {
+    while (len > 0) {
+        if (out->pos == out->cap) out_flush(out);
+        unsigned long n = std::min(len, out->cap - out->pos);
+        std::memcpy(out->buf + out->pos, s, n);
+        out->pos += n;
+        s += n;
+        len -= n;
+    }
+}
+
+
+void out_string(Out* out, const std::string& s) {
+    out_str(out, s.data(), s.size());
+}
+
+
+void out_char(Out* out, char c) {
+    if (out->pos == out->cap) out_flush(out);
+    out->buf[out->pos++] = c;
+}
+
+
+void out_ul(Out* out, unsigned long value) {
+    char tmp[20];
+    int i = 20;
+    do {
+        tmp[--i] = (char) ('0' + value % 10);
+        value /= 10;
+    } while (value);
+    out_str(out, tmp + i, 20 - i);
+}
@@ -0,0 +1,53 @@
+/*
+ *
+ * Buffered output.
+ * Formats everything into one large char buffer and hands it to
+ * write(2) once per chunk. Replaces std::cout << ... << std::endl,
+ * which flushes once per printed vertex.
+ *
+ */
+
+#ifndef PP_AE_VC_OUT_H
+#define PP_AE_VC_OUT_H
+
+#include <string>
+
+
+typedef struct __out {
+    int fd;
+    char* buf;
+    unsigned long pos;
+    unsigned long cap;
+    bool failed;   // a write(2) failed, the output is incomplete
+} Out;
+
+
+/*
+ * Opens an output sink on the given file descriptor (1 = stdout).
+ * std::cout is flushed first so earlier output keeps its order.
+ */
+void out_open(Out* out, int fd = 1);
+
+/*
+ * Writes the buffered bytes with write(2). Sets failed on an error.
+ */
+void out_flush(Out* out);
+
+/*
+ * Flushes and frees the buffer. The sink can not be used afterwards.
+ */
+void out_close(Out* out);
+
+void out_str(Out* out, const char* s, unsigned long len);
+
+void out_string(Out* out, const std::string& s);
+
+void out_char(Out* out, char c);
+
+/*
+ * Formats a number directly into the buffer. No std::to_string.
+ */
+void out_ul(Out* out, unsigned long value);
+
+
+#endif //PP_AE_VC_OUT_H
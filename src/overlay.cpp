@@ -0,0 +1,126 @@
+#include "overlay.h"
+
+#include <algorithm>
+
+
+template<typename G>
+void overlay_init(Overlay<G>* o, const G* csr, const std::vector<char>* alive,
+                  const std::vector<uint32_t>* degree, unsigned long edges) {
+    o->csr = csr;
+    o->parent = nullptr;
+    o->base_alive = alive;
+    o->base_degree = degree;
+    o->edges = edges;
+    overlay_discard(o);
+}
+
+
+template<typename G>
+void overlay_fork(Overlay<G>* child, const Overlay<G>* parent) {
+    child->csr = parent->csr;
+    child->parent = parent;
+    child->base_alive = nullptr;
+    child->base_degree = nullptr;
+    child->edges = parent->edges;
+    overlay_discard(child);
+}
+
+
+template<typename G>
+void overlay_discard(Overlay<G>* o) {
+    if (o->stamp.size() != o->csr->n) {
+        o->stamp.assign(o->csr->n, 0);
+        o->alive.resize(o->csr->n);
+        o->degree.resize(o->csr->n);
+        o->generation = 0;
+    }
+    if (++o->generation == 0) {
+        // wrapped around, old stamps could look valid again
+        std::fill(o->stamp.begin(), o->stamp.end(), 0);
+        o->generation = 1;
+    }
+    o->touched.clear();
+    o->taken = 0;
+    if (o->parent) o->edges = o->parent->edges;
+}
+
+
+template<typename G>
+bool overlay_alive(const Overlay<G>* o, uint32_t v) {
+    for (; o; o = o->parent) {
+        if (o->stamp[v] == o->generation) return o->alive[v];
+        if (!o->parent) return o->base_alive ? (*o->base_alive)[v] : true;
+    }
+    return true;
+}
+
+
+template<typename G>
+uint32_t overlay_degree(const Overlay<G>* o, uint32_t v) {
+    for (; o; o = o->parent) {
+        if (o->stamp[v] == o->generation) return o->degree[v];
+        if (!o->parent) return o->base_degree ? (*o->base_degree)[v] : degree_of(o->csr, v);
+    }
+    return 0;
+}
+
+
+template<typename G>
+static void set_node(Overlay<G>* o, uint32_t v, bool alive, uint32_t degree) {
+    o->stamp[v] = o->generation;
+    o->alive[v] = alive;
+    o->degree[v] = degree;
+}
+
+
+template<typename G>
+void overlay_remove(Overlay<G>* o, uint32_t v, bool take) {
+    set_node(o, v, false, overlay_degree(o, v));
+    o->edges -= o->degree[v];
+    for_each_neighbour(o->csr, v, [&](uint32_t u) {
+        if (!overlay_alive(o, u)) return true;
+        set_node(o, u, true, overlay_degree(o, u) - 1);
+        o->touched.push_back(u);
+        return true;
+    });
+    if (take) o->taken++;
+}
+
+
+template<typename G>
+unsigned long overlay_reduce(Overlay<G>* o) {
+    unsigned long taken = o->taken;
+    while (!o->touched.empty()) {
+        uint32_t v = o->touched.back();
+        o->touched.pop_back();
+        if (!overlay_alive(o, v)) continue;
+        uint32_t degree = overlay_degree(o, v);
+        if (degree == 0) {
+            overlay_remove(o, v, false);
+        } else if (degree == 1) {
+            uint32_t neighbour = UINT32_MAX;
+            for_each_neighbour(o->csr, v, [&](uint32_t u) {
+                if (!overlay_alive(o, u)) return true;
+                neighbour = u;
+                return false;
+            });
+            overlay_remove(o, neighbour, true);
+            overlay_remove(o, v, false);
+        }
+    }
+    return o->taken - taken;
+}
+
+
+#define OVERLAY_INSTANTIATE(G) \
+    template void overlay_init(Overlay<G>*, const G*, const std::vector<char>*, const std::vector<uint32_t>*, unsigned long); \
+    template void overlay_fork(Overlay<G>*, const Overlay<G>*); \
+    template void overlay_discard(Overlay<G>*); \
+    template bool overlay_alive(const Overlay<G>*, uint32_t); \
+    template uint32_t overlay_degree(const Overlay<G>*, uint32_t); \
+    template void overlay_remove(Overlay<G>*, uint32_t, bool); \
+    template unsigned long overlay_reduce(Overlay<G>*);
+
+OVERLAY_INSTANTIATE(Csr)
+OVERLAY_INSTANTIATE(NarrowCsr<uint16_t>)
+OVERLAY_INSTANTIATE(NarrowCsr<uint32_t>)
@@ -0,0 +1,81 @@
+/*
+ *
+ * Copy-on-write view of a graph state for probing and lookahead.
+ * The base is a Csr plus the alive flags and degrees of a search state
+ * (or the plain Csr). An overlay only records the nodes and degrees it
+ * changed, lookups fall through to the parent overlay and then to the
+ * base. The base is never written.
+ * Changes are kept in arrays indexed by node id and marked valid by a
+ * generation stamp. They are allocated the first time an Overlay object
+ * is used; after that fork and discard only bump the generation, so an
+ * overlay that is reused for many probes costs O(changes) per probe.
+ * G is Csr or a NarrowCsr (see narrow.h), instantiated in overlay.cpp.
+ *
+ */
+
+#ifndef PP_AE_VC_OVERLAY_H
+#define PP_AE_VC_OVERLAY_H
+
+#include <vector>
+
+#include "csr.h"
+#include "narrow.h"
+
+
+template<typename G>
+struct Overlay {
+    const G* csr;
+    const Overlay* parent = nullptr;
+    const std::vector<char>* base_alive = nullptr;       // nullptr: all nodes alive
+    const std::vector<uint32_t>* base_degree = nullptr;  // nullptr: degrees of csr
+    std::vector<uint32_t> stamp;                         // stamp[v] == generation: v changed here
+    std::vector<char> alive;
+    std::vector<uint32_t> degree;
+    uint32_t generation = 0;
+    std::vector<uint32_t> touched;                       // nodes whose degree dropped, for overlay_reduce
+    unsigned long edges = 0;                             // edges left
+    unsigned long taken = 0;                             // nodes removed into the cover
+};
+
+
+/*
+ * Root overlay over csr with the given state, which must outlive it.
+ * alive and degree may be nullptr for the unchanged csr.
+ */
+template<typename G>
+void overlay_init(Overlay<G>* o, const G* csr, const std::vector<char>* alive,
+                  const std::vector<uint32_t>* degree, unsigned long edges);
+
+/*
+ * child starts out equal to parent. parent must not change while child is used.
+ */
+template<typename G>
+void overlay_fork(Overlay<G>* child, const Overlay<G>* parent);
+
+/*
+ * Drops all changes of o, it is equal to its parent again.
+ */
+template<typename G>
+void overlay_discard(Overlay<G>* o);
+
+template<typename G>
+bool overlay_alive(const Overlay<G>* o, uint32_t v);
+
+template<typename G>
+uint32_t overlay_degree(const Overlay<G>* o, uint32_t v);
+
+/*
+ * Removes v, into the cover if take is set.
+ */
+template<typename G>
+void overlay_remove(Overlay<G>* o, uint32_t v, bool take);
+
+/*
+ * Degree zero and degree one rule on the nodes touched since the last call.
+ * Returns the number of nodes it took into the cover.
+ */
+template<typename G>
+unsigned long overlay_reduce(Overlay<G>* o);
+
+
+#endif //PP_AE_VC_OVERLAY_H
@@ -0,0 +1,43 @@
+#include "packed.h"
+
+
+static void put_varint(std::vector<uint8_t>* bytes, uint32_t x) {
+    while (x >= 0x80) {
+        bytes->push_back((uint8_t) (x | 0x80));
+        x >>= 7;
+    }
+    bytes->push_back((uint8_t) x);
+}
+
+
+PackedCsr pack_csr(const Csr* csr) {
+    PackedCsr packed;
+    packed.n = csr->n;
+    packed.m = csr->m;
+    packed.forced = csr->forced;
+    packed.offsets.resize(csr->n + 1);
+    packed.degree.resize(csr->n);
+    packed.bytes.reserve(csr->adj.size() * 2);
+    for (uint32_t v = 0; v < csr->n; v++) {
+        packed.offsets[v] = packed.bytes.size();
+        packed.degree[v] = csr_degree(csr, v);
+        uint32_t previous = 0;
+        for (uint64_t i = csr->offsets[v]; i < csr->offsets[v + 1]; i++) {
+            put_varint(&packed.bytes, csr->adj[i] - previous);
+            previous = csr->adj[i];
+        }
+    }
+    packed.offsets[csr->n] = packed.bytes.size();
+    packed.bytes.shrink_to_fit();
+    return packed;
+}
+
+
+bool pack_preferred(unsigned long n, unsigned long m) {
+    // below 64 MiB of plain adjacency the copy is not worth it
+    if (m * 2 * sizeof(uint32_t) < (64UL << 20)) return false;
+    double gap = (double) n * n / (2.0 * m);
+    unsigned long bytes = 1;
+    for (double limit = 128; gap >= limit && bytes < 5; limit *= 128) bytes++;
+    return bytes <= 2;
+}
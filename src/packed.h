@@ -0,0 +1,62 @@
+/*
+ *
+ * Compressed adjacency.
+ * Every sorted neighbour list is stored as its first id followed by the
+ * gaps to the previous id, each as a LEB128 varint (7 bits per byte).
+ * Sparse graphs with local ids (e.g. after --order rcm) mostly need one
+ * or two bytes per entry instead of four.
+ * Lists are decoded on the fly while iterating, nothing is unpacked.
+ *
+ * Read only consumers are written against for_each_neighbour() and
+ * degree_of(), which exist for Csr and PackedCsr.
+ *
+ */
+
+#ifndef PP_AE_VC_PACKED_H
+#define PP_AE_VC_PACKED_H
+
+#include <cstdint>
+#include <vector>
+
+#include "csr.h"
+
+
+typedef struct __packed_csr {
+    unsigned long n = 0;
+    unsigned long m = 0;
+    std::vector<uint64_t> offsets;   // byte offset of the list of v
+    std::vector<uint32_t> degree;
+    std::vector<uint8_t> bytes;
+    std::vector<uint32_t> forced;    // like Csr::forced
+} PackedCsr;
+
+
+inline unsigned long degree_of(const PackedCsr* g, uint32_t v) {
+    return g->degree[v];
+}
+
+template<typename F>
+inline bool for_each_neighbour(const PackedCsr* g, uint32_t v, F f) {
+    const uint8_t* p = g->bytes.data() + g->offsets[v];
+    uint32_t u = 0;
+    for (uint32_t i = g->degree[v]; i > 0; i--) {
+        uint32_t gap = *p & 0x7f;
+        for (int shift = 7; *p++ & 0x80; shift += 7) gap |= (uint32_t) (*p & 0x7f) << shift;
+        u += gap;
+        if (!f(u)) return false;
+    }
+    return true;
+}
+
+PackedCsr pack_csr(const Csr* csr);
+
+/*
+ * True if the packed form of a graph with n nodes and m edges is
+ * expected to be clearly smaller and the graph is large enough for
+ * memory to matter. Decided from n and m only: the average gap is
+ * about n / average degree.
+ */
+bool pack_preferred(unsigned long n, unsigned long m);
+
+
+#endif //PP_AE_VC_PACKED_H
@@ -0,0 +1,40 @@
+/*
+ *
+ * Small helpers for fork-join parallelism with std::thread.
+ *
+ */
+
+#ifndef PP_AE_VC_PARALLEL_H
+#define PP_AE_VC_PARALLEL_H
+
+#include <thread>
+#include <vector>
+
+
+/*
+ * Runs f(0) .. f(threads - 1), each in its own thread, and waits.
+ * f(0) runs on the calling thread.
+ */
+template<typename F>
+void run_parallel(unsigned long threads, F f) {
+    std::vector<std::thread> workers;
+    for (unsigned long t = 1; t < threads; t++) workers.emplace_back(f, t);
+    f(0);
+    for (auto& worker: workers) worker.join();
+}
+
+/*
+ * Calls f(i) for i in [0, n), split into one contiguous range per thread.
+ */
+template<typename F>
+void parallel_for(unsigned long n, unsigned long threads, F f) {
+    if (threads > n) threads = n > 0 ? n : 1;
+    run_parallel(threads, [&](unsigned long t) {
+        unsigned long begin = n * t / threads;
+        unsigned long end = n * (t + 1) / threads;
+        for (unsigned long i = begin; i < end; i++) f(i);
+    });
+}
+
+
+#endif //PP_AE_VC_PARALLEL_H
@@ -0,0 +1,362 @@
+#include "pipeline.h"
+
+#include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+#include "dr.h"
+#include "lb.h"
+#include "ub.h"
+#include "bnb.h"
+#include "reader.h"
+#include "order.h"
+#include "core.h"
+#include "parallel.h"
+#include "verify.h"
+#include "incumbent.h"
+#include "packed.h"
+#include "trace.h"
+
+
+static std::vector<std::string> split_list(const std::string& s) {
+    std::vector<std::string> parts;
+    std::stringstream stream(s);
+    std::string part;
+    while (std::getline(stream, part, ',')) {
+        if (!part.empty() && part != "none") parts.push_back(part);
+    }
+    return parts;
+}
+
+
+void print_usage(std::ostream& out) {
+    out << "usage: PP_AE_VC [--mode ub|lb|exact|kernel|lift|stream] [--time-limit SEC] [--threads N]\n"
+           "                [--reductions deg_one|none] [--bounds basic,clique,lp,cycle] [--lb-budget SEC]\n"
+           "                [--ub max_deg|rand|degeneracy|mis|race|matching] [--seed N] [--rand] [--stats]\n"
+           "                [--order none|degeneracy|bfs|rcm] [--format auto|pairs|dimacs|pace|metis]\n"
+           "                [--batch DIR|MANIFEST] [--batch-ref DIR]\n"
+           "                [--stream-passes N] [--kernel-out FILE] [--trace FILE]\n"
+           "reads the graph from stdin, writes the result to stdout\n"
+           "with --batch solves every instance (ub, lb or exact) and writes a csv" << std::endl;
+}
+
+
+bool parse_options(int argc, char** argv, Options* options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (arg == "--stats") options->stats = true;
+        else if (arg == "--rand") options->ub = "rand";
+        else if (arg == "--help" || arg == "-h") {
+            print_usage(std::cout);
+            return false;
+        } else if (!has_value) {
+            std::cerr << "missing value for " << arg << std::endl;
+            print_usage(std::cerr);
+            return false;
+        } else if (arg == "--mode") options->mode = argv[++i];
+        else if (arg == "--time-limit") options->time_limit = std::stod(argv[++i]);
+        else if (arg == "--threads") options->threads = std::max(1UL, std::stoul(argv[++i]));
+        else if (arg == "--reductions") options->reductions = split_list(argv[++i]);
+        else if (arg == "--bounds") options->bounds = split_list(argv[++i]);
+        else if (arg == "--lb-budget") options->lb_budget = std::stod(argv[++i]);
+        else if (arg == "--ub") options->ub = argv[++i];
+        else if (arg == "--order") options->order = argv[++i];
+        else if (arg == "--format") options->format = argv[++i];
+        else if (arg == "--batch") options->batch = argv[++i];
+        else if (arg == "--batch-ref") options->batch_ref = argv[++i];
+        else if (arg == "--stream-passes") options->stream_passes = std::stoul(argv[++i]);
+        else if (arg == "--kernel-out") options->kernel_out = argv[++i];
+        else if (arg == "--trace") options->trace = argv[++i];
+        else if (arg == "--seed") {
+            options->seed = std::stoull(argv[++i]);
+            options->seeded = true;
+        } else {
+            std::cerr << "unknown option " << arg << std::endl;
+            print_usage(std::cerr);
+            return false;
+        }
+    }
+
+    const std::vector<std::string> modes = {"ub", "lb", "exact", "kernel", "lift", "stream"};
+    if (!option_enabled(modes, options->mode)) {
+        std::cerr << "unknown mode " << options->mode << std::endl;
+        print_usage(std::cerr);
+        return false;
+    }
+
+    if (!options->batch.empty() && !option_enabled({"ub", "lb", "exact"}, options->mode)) {
+        std::cerr << "--batch supports the modes ub, lb and exact" << std::endl;
+        return false;
+    }
+    if (!options->batch.empty() && !options->trace.empty()) {
+        std::cerr << "--trace records a single instance, it can not be used with --batch" << std::endl;
+        return false;
+    }
+
+    const std::vector<std::string> ubs = {"max_deg", "rand", "degeneracy", "mis", "race", "matching"};
+    if (!option_enabled(ubs, options->ub)) {
+        std::cerr << "unknown ub " << options->ub << std::endl;
+        print_usage(std::cerr);
+        return false;
+    }
+
+    const std::vector<std::string> lbs = {"basic", "clique", "lp", "cycle"};
+    for (const auto& name: options->bounds) {
+        if (!option_enabled(lbs, name)) {
+            std::cerr << "unknown bound " << name << std::endl;
+            print_usage(std::cerr);
+            return false;
+        }
+    }
+
+    const std::vector<std::string> formats = {"auto", "pairs", "dimacs", "pace", "metis"};
+    if (!option_enabled(formats, options->format)) {
+        std::cerr << "unknown format " << options->format << std::endl;
+        print_usage(std::cerr);
+        return false;
+    }
+
+    const std::vector<std::string> orders = {"none", "degeneracy", "bfs", "rcm"};
+    if (!option_enabled(orders, options->order)) {
+        std::cerr << "unknown order " << options->order << std::endl;
+        print_usage(std::cerr);
+        return false;
+    }
+
+    options->deadline = deadline_after(options->time_limit);
+    return true;
+}
+
+
+std::chrono::steady_clock::time_point deadline_after(double time_limit) {
+    if (time_limit <= 0) return std::chrono::steady_clock::time_point::max();
+    return std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(time_limit));
+}
+
+
+bool option_enabled(const std::vector<std::string>& list, const std::string& name) {
+    return std::find(list.begin(), list.end(), name) != list.end();
+}
+
+
+static Csr read_or_exit(const char* data, unsigned long size, const Options* options) {
+    std::string error;
+    Csr csr = csr_read(data, size, options->threads, options->format, &error);
+    if (!error.empty()) {
+        std::cerr << error << std::endl;
+        exit(1);
+    }
+    return csr;
+}
+
+
+Csr load_csr(const Options* options) {
+    InputBuffer input;
+    input_open(&input, 0);
+    Csr csr = read_or_exit(input.data, input.size, options);
+    input_close(&input);
+    csr_reorder(&csr, options->order);
+    return csr;
+}
+
+
+Graph* load_graph(const Options* options) {
+    Csr csr = load_csr(options);
+    return graph_from_csr(&csr);
+}
+
+
+Graph* load_graph(const std::string& text, const Options* options) {
+    Csr csr = read_or_exit(text.data(), text.size(), options);
+    csr_reorder(&csr, options->order);
+    return graph_from_csr(&csr);
+}
+
+
+unsigned long run_reductions(Graph* graph, const Options* options, std::stack<bool*>* res_stack,
+                             BoundAccount* account) {
+    unsigned long forced = 0;
+    // self-loops, not optional
+    for (bool* node: graph->forced) {
+        if (!*node) continue;
+        res_stack->push(node);
+        delete_node_erase(node, graph);
+        forced++;
+    }
+    unsigned long reduced = 0;
+    if (option_enabled(options->reductions, "deg_one")) reduced = deg_one(graph, res_stack);
+    if (account) {
+        account->forced += forced;
+        account->reduced += reduced;
+    }
+    trace_set_offset(forced + reduced);
+    trace_record(ULONG_MAX, 0, "reduce");
+    return forced + reduced;
+}
+
+
+/*
+ * Takes the graph based heuristic on graph itself, the cover is
+ * translated to ids of kernel (a snapshot of graph) with nodes.
+ */
+static std::vector<uint32_t> max_deg_cover(Graph* graph, const std::vector<bool*>& nodes,
+                                           const std::string& ub, Rng* rng) {
+    std::vector<uint32_t> local(graph->n, UINT32_MAX);
+    for (uint32_t v = 0; v < nodes.size(); v++) local[node_id(nodes[v], graph)] = v;
+
+    std::stack<bool*> res_stack;
+    if (ub == "rand") max_deg_heur_rand(graph, &res_stack, rng);
+    else max_deg_heur(graph, &res_stack);
+    std::vector<uint32_t> cover;
+    while (!res_stack.empty()) {
+        cover.push_back(local[node_id(res_stack.top(), graph)]);
+        res_stack.pop();
+    }
+    return cover;
+}
+
+
+/*
+ * Every heuristic cover ends up here: made minimal, and checked in debug builds.
+ */
+static std::vector<uint32_t> finish_cover(const Csr* kernel, std::vector<uint32_t> cover) {
+    prune_redundant(kernel, &cover);
+    assert(verify_cover(kernel, cover));
+    return cover;
+}
+
+
+std::vector<uint32_t> upper_bound_cover(const Csr* kernel, const std::string& ub, Rng* rng) {
+    if (ub == "degeneracy") {
+        Cores cores = core_decomposition(kernel);
+        return finish_cover(kernel, ub_degeneracy(kernel, &cores));
+    }
+    if (ub == "mis") return finish_cover(kernel, ub_min_degree_mis(kernel));
+    if (ub == "matching") return finish_cover(kernel, ub_matching(kernel));
+    if (ub == "race") {
+        // every engine on its own thread, the smallest cover wins
+        const std::vector<std::string> engines = {"max_deg", "degeneracy", "mis"};
+        Incumbent incumbent;
+        incumbent.phase = "race";
+        run_parallel(engines.size(), [&](unsigned long t) {
+            incumbent_offer(&incumbent, upper_bound_cover(kernel, engines[t], rng));
+        });
+        return incumbent_cover(&incumbent);
+    }
+
+    // graph based heuristics, on a copy that keeps the ids of kernel
+    Graph* graph = graph_from_csr(kernel);
+    std::vector<bool*> nodes(kernel->n);
+    for (uint32_t v = 0; v < kernel->n; v++) nodes[v] = &graph->indicators[v];
+    std::vector<uint32_t> cover = max_deg_cover(graph, nodes, ub, rng);
+    delete_graph(graph);
+    return finish_cover(kernel, cover);
+}
+
+
+bool packed_ub_preferred(const Csr* csr, const Options* options) {
+    return (options->ub == "mis" || options->ub == "degeneracy") && pack_preferred(csr->n, csr->m);
+}
+
+
+std::vector<uint32_t> packed_upper_bound(Csr* csr, const Options* options) {
+    PackedCsr packed = pack_csr(csr);
+    // only labels and forced are needed from here on
+    std::vector<uint64_t>().swap(csr->offsets);
+    std::vector<uint32_t>().swap(csr->adj);
+    std::vector<uint32_t>().swap(csr->matching);
+
+    std::vector<uint32_t> cover;
+    if (options->ub == "mis") {
+        cover = ub_min_degree_mis(&packed);
+    } else {
+        Cores cores = core_decomposition(&packed);
+        cover = ub_degeneracy(&packed, &cores);
+    }
+    prune_redundant(&packed, &cover);
+    assert(verify_cover(&packed, cover));
+    // self-loop nodes after pruning, it does not know about them
+    std::vector<char> in_cover(packed.n, 0);
+    for (uint32_t v: cover) in_cover[v] = 1;
+    for (uint32_t v: csr->forced) {
+        if (!in_cover[v]) cover.push_back(v);
+    }
+    trace_record(cover.size(), 0, "ub");
+    return cover;
+}
+
+
+unsigned long run_upper_bound(Graph* graph, const Options* options, std::stack<bool*>* res_stack, Rng* rng) {
+    std::vector<bool*> nodes;
+    Csr kernel = csr_from_graph(graph, &nodes);
+    std::vector<uint32_t> cover;
+    if (options->ub == "max_deg" || options->ub == "rand") {
+        // no copy needed, graph is not used afterwards
+        cover = finish_cover(&kernel, max_deg_cover(graph, nodes, options->ub, rng));
+    } else {
+        cover = upper_bound_cover(&kernel, options->ub, rng);
+    }
+    trace_record(cover.size(), 0, "ub");
+    for (uint32_t v: cover) {
+        res_stack->push(nodes[v]);
+        if (*nodes[v]) delete_node(nodes[v], graph);
+    }
+    return cover.size();
+}
+
+
+static unsigned long lower_bound_value(Graph* graph, const std::string& name, Deadline deadline) {
+    if (name == "basic") return basic_lb(graph);
+    if (name == "clique") return clique_cover_lb(graph, deadline);
+    if (name == "lp") return lpb(graph, deadline);
+    if (name == "cycle") return cycle_bound(graph, deadline);
+    return 0;
+}
+
+
+unsigned long run_lower_bound(const Csr* kernel, const Options* options, BoundAccount* account) {
+    const std::vector<std::string>& bounds = options->bounds;
+    if (bounds.empty()) return account_total(account);
+    std::vector<Csr> components = csr_components(kernel);
+    // value[c * bounds + b], 0 until bound b finished component c
+    std::vector<unsigned long> value(components.size() * bounds.size(), 0);
+
+    std::atomic<unsigned long> next{0};
+    run_parallel(std::min(options->threads, (unsigned long) bounds.size()), [&](unsigned long) {
+        for (unsigned long b = next++; b < bounds.size(); b = next++) {
+            auto deadline = options->deadline;
+            if (options->lb_budget > 0) deadline = std::min(deadline, deadline_after(options->lb_budget));
+            for (unsigned long c = 0; c < components.size(); c++) {
+                if (std::chrono::steady_clock::now() >= deadline) break;
+                // the bounds delete nodes, so every bound gets a fresh copy
+                Graph* graph = graph_from_csr(&components[c]);
+                value[c * bounds.size() + b] = lower_bound_value(graph, bounds[b], deadline);
+                delete_graph(graph);
+            }
+        }
+    });
+
+    unsigned long total = 0;
+    for (unsigned long c = 0; c < components.size(); c++) {
+        total += *std::max_element(value.begin() + c * bounds.size(), value.begin() + (c + 1) * bounds.size());
+    }
+    account_raise_kernel(account, total);
+    trace_record(ULONG_MAX, account->kernel, "lb");
+    return account_total(account);
+}
+
+
+std::vector<uint32_t> run_exact(const Csr* kernel, const Options* options, Rng* rng, bool* optimal,
+                                const BoundAccount* account) {
+    // start the search from the heuristic cover
+    std::vector<uint32_t> initial = upper_bound_cover(kernel, options->ub, rng);
+    trace_record(initial.size(), account ? account->kernel : 0, "ub");
+    BnbResult result = bnb_solve(kernel, initial, options->deadline, options->threads, account ? account->kernel : 0);
+    assert(verify_cover(kernel, result.cover));
+    if (optimal) *optimal = result.optimal;
+    return result.cover;
+}
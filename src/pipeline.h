@@ -0,0 +1,185 @@
+/*
+ *
+ * Command line options and the stages all modes are built from.
+ * Every stage works on an already loaded graph, so pipelines can be
+ * put together (and measured) without recompiling.
+ *
+ * Modes (same names as the checker modes):
+ * - ub:     reductions + heuristic, prints a cover
+ * - lb:     reductions + lower bounds, prints one number
+ * - exact:  reductions + branch and bound, prints a minimum cover
+ * - kernel: reductions, prints the kernel and the difference budget
+ * - lift:   reads input graph, kernel and kernel cover, prints a cover
+ *           of the input graph
+ * - stream: semi-external reductions + matching cover, for graphs
+ *           whose edges do not fit in memory (see stream.h)
+ *
+ */
+
+#ifndef PP_AE_VC_PIPELINE_H
+#define PP_AE_VC_PIPELINE_H
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <stack>
+#include <string>
+#include <vector>
+
+#include "graph.h"
+#include "csr.h"
+#include "rng.h"
+
+
+typedef struct __options {
+    std::string mode = "ub";
+    double time_limit = 0;     // seconds, 0 means no limit
+    unsigned long threads = 1;
+    std::vector<std::string> reductions = {"deg_one"};
+    std::vector<std::string> bounds = {"basic", "clique", "lp"};
+    double lb_budget = 0;      // seconds per lower bound, 0 means only the time limit
+    std::string ub = "max_deg";
+    std::string order = "none";  // vertex ordering after loading, see order.h
+    std::string format = "auto"; // input format, see reader.h
+    uint64_t seed = 0;
+    bool seeded = false;
+    bool stats = false;
+    std::string batch;         // directory or manifest of instances, see batch.h
+    std::string batch_ref;     // directory of the reference .out files
+    unsigned long stream_passes = 8;  // degree one passes in stream mode
+    std::string kernel_out;    // stream mode writes its kernel here
+    std::string trace;         // csv of cover size and bound over time, see trace.h
+    std::chrono::steady_clock::time_point deadline;
+} Options;
+
+
+/*
+ * Lower bound bookkeeping across the reductions. Reductions only take
+ * nodes that are in some minimum cover, so for the input graph
+ * OPT = offset + OPT(kernel): bounds on either level convert exactly.
+ */
+typedef struct __bound_account {
+    unsigned long forced = 0;   // self-loop nodes
+    unsigned long reduced = 0;  // nodes taken by the reductions (deg_one)
+    unsigned long kernel = 0;   // best lower bound on the kernel so far
+} BoundAccount;
+
+
+inline unsigned long account_offset(const BoundAccount* account) {
+    return account->forced + account->reduced;
+}
+
+/*
+ * Lower bound on the input graph.
+ */
+inline unsigned long account_total(const BoundAccount* account) {
+    return account_offset(account) + account->kernel;
+}
+
+inline void account_raise_kernel(BoundAccount* account, unsigned long kernel_lb) {
+    if (kernel_lb > account->kernel) account->kernel = kernel_lb;
+}
+
+/*
+ * Takes a lower bound on the input graph (e.g. the reader's matching)
+ * after the reductions ran.
+ */
+inline void account_raise_total(BoundAccount* account, unsigned long total_lb) {
+    if (total_lb > account_offset(account)) account_raise_kernel(account, total_lb - account_offset(account));
+}
+
+
+/*
+ * Parses argv into options. Prints the usage and returns false on errors.
+ */
+bool parse_options(int argc, char** argv, Options* options);
+
+void print_usage(std::ostream& out);
+
+/*
+ * Now + time_limit seconds, no deadline for time_limit <= 0.
+ */
+std::chrono::steady_clock::time_point deadline_after(double time_limit);
+
+bool option_enabled(const std::vector<std::string>& list, const std::string& name);
+
+/*
+ * Reads the graph from stdin with the parallel CSR reader (--threads)
+ * and relabels it with the selected ordering (--order).
+ */
+Csr load_csr(const Options* options);
+
+/*
+ * Same, as a Graph for the reductions.
+ */
+Graph* load_graph(const Options* options);
+
+/*
+ * Same for a graph that is already in memory.
+ */
+Graph* load_graph(const std::string& text, const Options* options);
+
+/*
+ * Takes the nodes with a self-loop and applies the enabled reductions.
+ * Forced nodes are pushed onto res_stack and counted in account.
+ * Returns the number of forced nodes.
+ */
+unsigned long run_reductions(Graph* graph, const Options* options, std::stack<bool*>* res_stack,
+                             BoundAccount* account = nullptr);
+
+/*
+ * Covers the rest of graph with the selected heuristic (--ub).
+ * Redundant nodes are pruned, the cover is minimal.
+ * Returns the number of nodes pushed onto res_stack.
+ */
+unsigned long run_upper_bound(Graph* graph, const Options* options, std::stack<bool*>* res_stack, Rng* rng);
+
+/*
+ * True if the input is large and sparse enough for packed_upper_bound()
+ * (pack_preferred) and --ub is one of its engines (mis, degeneracy).
+ */
+bool packed_ub_preferred(const Csr* csr, const Options* options);
+
+/*
+ * Cover of the input graph for large inputs, without a Graph or kernel:
+ * the adjacency of csr is packed (packed.h) and freed, then mis or
+ * degeneracy run on the packed form. Peak memory is the reader's Csr,
+ * not Csr + Graph + kernel. There are no reductions, both engines
+ * start from low degree nodes anyway. Self-loop nodes are added.
+ * Returns ids of csr, only csr->labels stays valid.
+ */
+std::vector<uint32_t> packed_upper_bound(Csr* csr, const Options* options);
+
+/*
+ * Minimal cover of kernel by heuristic ub, as ids of kernel.
+ * "race" runs max_deg, degeneracy and mis in parallel threads
+ * and returns the smallest cover. "matching" takes both endpoints of
+ * a maximal matching, then prunes.
+ */
+std::vector<uint32_t> upper_bound_cover(const Csr* kernel, const std::string& ub, Rng* rng);
+
+/*
+ * Lower bound for kernel from the enabled bounds (--bounds).
+ * kernel is split into components, the bounds run in parallel
+ * (--threads), each on its own copies and within its own budget
+ * (--lb-budget, and the time limit). The deadline is passed into
+ * lp (checked between Hopcroft-Karp phases), clique and cycle, which
+ * return their partial bound when it passes; components a bound did
+ * not reach count 0 for it. The result is the sum over the components
+ * of the best bound of each. kernel is not changed.
+ * The kernel bound goes into account, returns the bound on the input
+ * graph (account_total).
+ */
+unsigned long run_lower_bound(const Csr* kernel, const Options* options, BoundAccount* account);
+
+/*
+ * Minimum cover of kernel, as ids of kernel.
+ * Stops at the deadline with the best cover found, *optimal tells which.
+ * The kernel bound of account (if given) lets the search stop as soon
+ * as a cover reaches it.
+ */
+std::vector<uint32_t> run_exact(const Csr* kernel, const Options* options, Rng* rng, bool* optimal = nullptr,
+                                const BoundAccount* account = nullptr);
+
+
+#endif //PP_AE_VC_PIPELINE_H
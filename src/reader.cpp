@@ -0,0 +1,606 @@
+#include "reader.h"
+#include "parallel.h"
+#include "stats.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+void input_open(InputBuffer* input, int fd) {
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            madvise(p, st.st_size, MADV_SEQUENTIAL);
+            input->mapping = p;
+            input->data = static_cast<const char*>(p);
+            input->size = st.st_size;
+            return;
+        }
+    }
+    char buf[1 << 16];
+    ssize_t r;
+    while ((r = read(fd, buf, sizeof(buf))) > 0) input->owned.append(buf, r);
+    input->data = input->owned.data();
+    input->size = input->owned.size();
+}
+
+
+void input_close(InputBuffer* input) {
+    if (input->mapping) munmap(input->mapping, input->size);
+    input->mapping = nullptr;
+    input->owned.clear();
+    input->data = nullptr;
+    input->size = 0;
+}
+
+
+typedef struct __label_ref {
+    const char* p;
+    uint32_t len;
+} LabelRef;
+
+
+struct LabelHash {
+    size_t operator()(const LabelRef& l) const {
+        // FNV-1a
+        uint64_t h = 14695981039346656037ULL;
+        for (uint32_t i = 0; i < l.len; i++) h = (h ^ (unsigned char) l.p[i]) * 1099511628211ULL;
+        return h;
+    }
+};
+
+
+struct LabelEq {
+    bool operator()(const LabelRef& a, const LabelRef& b) const {
+        return a.len == b.len && std::memcmp(a.p, b.p, a.len) == 0;
+    }
+};
+
+
+typedef std::unordered_map<LabelRef, uint32_t, LabelHash, LabelEq> LabelMap;
+
+
+typedef struct __chunk {
+    const char* begin;
+    const char* end;
+    std::vector<LabelRef> labels;   // local id -> label (label formats only)
+    std::vector<uint32_t> edges;    // endpoint pairs, local ids, later global ids
+    std::vector<uint32_t> remap;    // local id -> global id, empty if edges hold global ids
+    std::vector<uint64_t> count;    // degree histogram, later write positions
+    std::vector<uint32_t> loops;    // nodes with a self-loop, global ids
+    uint32_t first_vertex = 0;      // metis: vertex of the first line
+    uint64_t max_id = 0;            // numbered formats: largest id + 1
+} Chunk;
+
+
+static inline bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+
+static const char* next_line(const char* p, const char* end) {
+    const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    return nl ? nl + 1 : end;
+}
+
+
+static const char* read_token(const char* p, const char* line_end, LabelRef* token) {
+    while (p < line_end && is_space(*p)) p++;
+    const char* start = p;
+    while (p < line_end && !is_space(*p) && *p != '\n') p++;
+    token->p = start;
+    token->len = p - start;
+    return p;
+}
+
+
+/*
+ * Next unsigned number of the line. Returns false at the end of the line.
+ */
+static bool read_number(const char** p, const char* line_end, uint64_t* value) {
+    const char* q = *p;
+    while (q < line_end && (*q < '0' || *q > '9')) {
+        if (!is_space(*q) && *q != '\n') return false;
+        q++;
+    }
+    if (q == line_end || *q < '0' || *q > '9') {
+        *p = q;
+        return false;
+    }
+    uint64_t v = 0;
+    while (q < line_end && *q >= '0' && *q <= '9') v = v * 10 + (*q++ - '0');
+    *p = q;
+    *value = v;
+    return true;
+}
+
+
+/*
+ * Splits [begin, end) into one chunk per thread at line boundaries.
+ */
+static std::vector<Chunk> split_chunks(const char* begin, const char* end, unsigned long threads, unsigned long expected_edges) {
+    std::vector<Chunk> chunks(threads);
+    const char* start = begin;
+    for (unsigned long t = 0; t < threads; t++) {
+        const char* stop = t + 1 == threads ? end : begin + (end - begin) * (t + 1) / threads;
+        if (stop > end) stop = end;
+        if (stop > start && stop < end && stop[-1] != '\n') stop = next_line(stop, end);
+        if (stop < start) stop = start;
+        chunks[t].begin = start;
+        chunks[t].end = stop;
+        chunks[t].edges.reserve(2 * expected_edges / threads + 16);
+        start = stop;
+    }
+    return chunks;
+}
+
+
+static void parse_chunk(Chunk* chunk) {
+    LabelMap local;
+    const char* p = chunk->begin;
+    while (p < chunk->end) {
+        const char* line_end = next_line(p, chunk->end);
+        if (*p == '#') {
+            p = line_end;
+            continue;
+        }
+        LabelRef a, b;
+        const char* q = read_token(p, line_end, &a);
+        read_token(q, line_end, &b);
+        p = line_end;
+        if (a.len == 0 || b.len == 0) continue;
+
+        for (const LabelRef& label: {a, b}) {
+            auto ins = local.emplace(label, (uint32_t) chunk->labels.size());
+            if (ins.second) chunk->labels.push_back(label);
+            chunk->edges.push_back(ins.first->second);
+        }
+    }
+}
+
+
+static inline void push_numbered_edge(Chunk* chunk, uint64_t a, uint64_t b) {
+    // ids in the file start at 1
+    if (a == 0 || b == 0 || a > UINT32_MAX || b > UINT32_MAX) return;
+    chunk->edges.push_back(a - 1);
+    chunk->edges.push_back(b - 1);
+    chunk->max_id = std::max(chunk->max_id, std::max(a, b));
+}
+
+
+/*
+ * dimacs: "e u v" lines, everything else is skipped.
+ * pace:   "u v" lines, 'c' lines are comments.
+ */
+static void parse_edge_chunk(Chunk* chunk, bool dimacs) {
+    const char* p = chunk->begin;
+    while (p < chunk->end) {
+        const char* line_end = next_line(p, chunk->end);
+        const char* q = p;
+        p = line_end;
+        while (q < line_end && is_space(*q)) q++;
+        if (dimacs) {
+            if (q == line_end || *q != 'e') continue;
+            q++;
+        } else if (q == line_end || *q == 'c' || *q == 'p') {
+            continue;
+        }
+        uint64_t a, b;
+        if (read_number(&q, line_end, &a) && read_number(&q, line_end, &b)) push_numbered_edge(chunk, a, b);
+    }
+}
+
+
+static inline bool is_metis_vertex_line(const char* p, const char* line_end) {
+    return p == line_end || *p != '%';
+}
+
+
+/*
+ * Line i (after the header, without '%' comments) lists the neighbours of vertex i.
+ * Every edge is listed at both ends, duplicates are removed when the Csr is built.
+ * vertex_numbers (size and weights) precede the neighbours, an edge
+ * weight follows every neighbour if edge_weights is set.
+ */
+static void parse_metis_chunk(Chunk* chunk, unsigned long vertex_numbers, bool edge_weights) {
+    const char* p = chunk->begin;
+    uint64_t v = chunk->first_vertex;
+    while (p < chunk->end) {
+        const char* line_end = next_line(p, chunk->end);
+        const char* q = p;
+        p = line_end;
+        if (!is_metis_vertex_line(q, line_end)) continue;
+        v++;
+        uint64_t value;
+        for (unsigned long w = 0; w < vertex_numbers; w++) read_number(&q, line_end, &value);
+        while (read_number(&q, line_end, &value)) {
+            push_numbered_edge(chunk, v, value);
+            if (edge_weights) read_number(&q, line_end, &value);
+        }
+        chunk->max_id = std::max(chunk->max_id, v);
+    }
+}
+
+
+/*
+ * Degree histograms, prefix sums, adjacency fill, then every list is
+ * sorted and deduplicated. Shared by all formats.
+ * Edges of the chunks are local ids if remap is set, global ids otherwise.
+ */
+static Csr build_csr(std::vector<Chunk>& chunks, unsigned long n, unsigned long threads) {
+    Csr csr;
+    csr.n = n;
+
+    run_parallel(threads, [&](unsigned long t) {
+        Chunk& chunk = chunks[t];
+        chunk.count.assign(csr.n, 0);
+        unsigned long kept = 0;
+        for (unsigned long i = 0; i < chunk.edges.size(); i += 2) {
+            uint32_t a = chunk.edges[i];
+            uint32_t b = chunk.edges[i + 1];
+            if (!chunk.remap.empty()) {
+                a = chunk.remap[a];
+                b = chunk.remap[b];
+            }
+            if (a == b) {
+                chunk.loops.push_back(a);
+                continue;
+            }
+            chunk.edges[kept++] = a;
+            chunk.edges[kept++] = b;
+            chunk.count[a]++;
+            chunk.count[b]++;
+        }
+        chunk.edges.resize(kept);
+    });
+
+    for (Chunk& chunk: chunks) csr.forced.insert(csr.forced.end(), chunk.loops.begin(), chunk.loops.end());
+    std::sort(csr.forced.begin(), csr.forced.end());
+    csr.forced.erase(std::unique(csr.forced.begin(), csr.forced.end()), csr.forced.end());
+
+    // greedy maximal matching in input order, forced nodes cover their edges anyway
+    {
+        std::vector<char> matched(csr.n, 0);
+        for (uint32_t v: csr.forced) matched[v] = 1;
+        for (const Chunk& chunk: chunks) {
+            for (unsigned long i = 0; i < chunk.edges.size(); i += 2) {
+                uint32_t a = chunk.edges[i];
+                uint32_t b = chunk.edges[i + 1];
+                if (matched[a] || matched[b]) continue;
+                matched[a] = matched[b] = 1;
+                csr.matching.push_back(a);
+                csr.matching.push_back(b);
+            }
+        }
+    }
+
+    // prefix sum, count[v] of every chunk becomes its first write position
+    std::vector<uint64_t> offsets(csr.n + 1, 0);
+    uint64_t run = 0;
+    for (uint32_t v = 0; v < csr.n; v++) {
+        offsets[v] = run;
+        for (Chunk& chunk: chunks) {
+            uint64_t c = chunk.count[v];
+            chunk.count[v] = run;
+            run += c;
+        }
+    }
+    offsets[csr.n] = run;
+
+    std::vector<uint32_t> adj(run);
+    run_parallel(threads, [&](unsigned long t) {
+        Chunk& chunk = chunks[t];
+        for (unsigned long i = 0; i < chunk.edges.size(); i += 2) {
+            uint32_t a = chunk.edges[i];
+            uint32_t b = chunk.edges[i + 1];
+            adj[chunk.count[a]++] = b;
+            adj[chunk.count[b]++] = a;
+        }
+        std::vector<uint32_t>().swap(chunk.edges);
+        std::vector<uint64_t>().swap(chunk.count);
+    });
+
+    // sort and dedup every list
+    std::vector<uint64_t> degree(csr.n + 1, 0);
+    parallel_for(csr.n, threads, [&](unsigned long v) {
+        auto first = adj.begin() + offsets[v];
+        auto last = adj.begin() + offsets[v + 1];
+        std::sort(first, last);
+        degree[v] = std::unique(first, last) - first;
+    });
+
+    csr.offsets.assign(csr.n + 1, 0);
+    for (uint32_t v = 0; v < csr.n; v++) csr.offsets[v + 1] = csr.offsets[v] + degree[v];
+    csr.adj.resize(csr.offsets[csr.n]);
+    parallel_for(csr.n, threads, [&](unsigned long v) {
+        std::copy(adj.begin() + offsets[v], adj.begin() + offsets[v] + degree[v], csr.adj.begin() + csr.offsets[v]);
+    });
+    csr.m = csr.adj.size() / 2;
+    return csr;
+}
+
+
+/*
+ * Numbered formats declare every vertex, the label pair format only
+ * knows vertices with an edge. Drops the others, so all formats
+ * give the same Csr for the same graph.
+ */
+static void drop_isolated(Csr* csr) {
+    std::vector<uint32_t> id(csr->n, UINT32_MAX);
+    std::vector<char> keep(csr->n, 0);
+    for (uint32_t v = 0; v < csr->n; v++) keep[v] = csr_degree(csr, v) > 0;
+    for (uint32_t v: csr->forced) keep[v] = 1;
+
+    uint32_t n = 0;
+    for (uint32_t v = 0; v < csr->n; v++) {
+        if (keep[v]) id[v] = n++;
+    }
+    if (n == csr->n) return;
+
+    std::vector<uint64_t> offsets(n + 1, 0);
+    for (uint32_t v = 0; v < csr->n; v++) {
+        if (!keep[v]) continue;
+        offsets[id[v] + 1] = offsets[id[v]] + csr_degree(csr, v);
+        // a self move would leave the label empty
+        if (id[v] != v) csr->labels[id[v]] = std::move(csr->labels[v]);
+    }
+    // ids only shrink, so adj can be compacted in place and stays sorted
+    for (uint32_t v = 0; v < csr->n; v++) {
+        if (!keep[v]) continue;
+        uint64_t to = offsets[id[v]];
+        for (uint64_t i = csr->offsets[v]; i < csr->offsets[v + 1]; i++) csr->adj[to++] = id[csr->adj[i]];
+    }
+    for (uint32_t& v: csr->forced) v = id[v];
+    for (uint32_t& v: csr->matching) v = id[v];
+    csr->offsets.swap(offsets);
+    csr->labels.resize(n);
+    csr->n = n;
+}
+
+
+/*
+ * Header line tokens, counted up to the end of the line.
+ */
+static unsigned long count_tokens(const char* p, const char* line_end) {
+    unsigned long tokens = 0;
+    LabelRef token;
+    while ((p = read_token(p, line_end, &token)), token.len > 0) tokens++;
+    return tokens;
+}
+
+
+/*
+ * Inputs that fit both formats: n lines after the header (blank ones
+ * included) and m lines of two tokens up to the first blank line.
+ * Reads the lines as metis adjacency: "pairs" if they are not (numbers
+ * in 1..n, no self-loops or repeats, j on line i iff i on line j, 2m
+ * entries), "metis" if they are and the pairs reading repeats an edge
+ * or is the same graph anyway. "" otherwise.
+ */
+static std::string resolve_ambiguous(const char* p, const char* end, uint64_t n, uint64_t m) {
+    std::vector<std::pair<uint64_t, uint64_t>> arcs, edges;
+    bool blank = false;
+    bool two_tokens = true;
+    uint64_t line = 0;
+    for (; p < end && line < n; p = next_line(p, end)) {
+        const char* line_end = next_line(p, end);
+        if (*p == '#') continue;
+        line++;
+        const char* q = p;
+        uint64_t v = 0, first = 0;
+        unsigned long count = 0;
+        while (read_number(&q, line_end, &v)) {
+            if (v < 1 || v > n || v == line) return "pairs";
+            arcs.emplace_back(line, v);
+            if (count++ == 0) first = v;
+        }
+        if (count_tokens(q, line_end) > 0) return "pairs";
+        if (count == 0) blank = true;
+        // as pairs, the lines up to the first blank one are the edges
+        if (!blank && count != 2) two_tokens = false;
+        if (!blank && count == 2) edges.emplace_back(std::min(first, v), std::max(first, v));
+    }
+    std::sort(arcs.begin(), arcs.end());
+    if (arcs.size() != 2 * m || std::adjacent_find(arcs.begin(), arcs.end()) != arcs.end()) return "pairs";
+    for (const auto& arc: arcs) {
+        if (!std::binary_search(arcs.begin(), arcs.end(), std::make_pair(arc.second, arc.first))) return "pairs";
+    }
+    if (!two_tokens) return "metis";
+
+    // symmetric, so metis is consistent
+    std::vector<std::pair<uint64_t, uint64_t>> metis_edges;
+    for (const auto& arc: arcs) {
+        if (arc.first < arc.second) metis_edges.push_back(arc);
+    }
+    std::sort(edges.begin(), edges.end());
+    if (std::adjacent_find(edges.begin(), edges.end()) != edges.end()) return "metis";
+    return edges == metis_edges ? "metis" : "";
+}
+
+
+std::string sniff_format(const char* data, unsigned long size) {
+    const char* end = data + size;
+    const char* p = data;
+    while (p < end) {
+        const char* line_end = next_line(p, end);
+        const char* q = p;
+        while (q < line_end && is_space(*q)) q++;
+        if (q == line_end || *q == '\n' || *q == '#') {
+            p = line_end;
+            continue;
+        }
+        if (*q == '%') return "metis";
+        if (*q == 'c' && (q + 1 == line_end || is_space(q[1]) || q[1] == '\n')) {
+            p = line_end;
+            continue;
+        }
+        if (*q == 'p') {
+            LabelRef token;
+            read_token(read_token(q, line_end, &token), line_end, &token);
+            std::string kind(token.p, token.len);
+            return kind == "edge" || kind == "col" ? "dimacs" : "pace";
+        }
+
+        // "n m [fmt [ncon]]": a course file or metis
+        if (count_tokens(q, line_end) > 2) return "metis";
+        uint64_t n = 0, m = 0;
+        read_number(&q, line_end, &n);
+        read_number(&q, line_end, &m);
+        // the course format ends at the first blank line, in metis a blank
+        // line is a vertex without neighbours, so both are counted
+        unsigned long lines = 0;
+        unsigned long edge_lines = 0;
+        bool blank = false;
+        bool two_tokens = true;
+        for (const char* r = line_end; r < end; r = next_line(r, end)) {
+            const char* r_end = next_line(r, end);
+            if (*r == '#') continue;
+            if (*r == '%') return "metis";
+            unsigned long tokens = count_tokens(r, r_end);
+            if (tokens == 0 && !blank) {
+                blank = true;
+                edge_lines = lines;
+            }
+            if (!blank && lines < 16 && tokens != 2) two_tokens = false;
+            lines++;
+        }
+        if (!blank) edge_lines = lines;
+        if (!two_tokens || (blank && edge_lines == 0)) return "metis";
+        if (lines != n) return "pairs";
+        if (edge_lines != m) return "metis";
+        return resolve_ambiguous(line_end, end, n, m);
+    }
+    return "pairs";
+}
+
+
+static Csr read_pairs(const char* data, unsigned long size, unsigned long threads) {
+    const char* end = data + size;
+    const char* p = data;
+
+    // header, "n m"
+    uint64_t header_m = 0;
+    while (p < end) {
+        const char* line_end = next_line(p, end);
+        if (*p == '#') {
+            p = line_end;
+            continue;
+        }
+        // bounded by the line, the mapped input has no terminating NUL
+        const char* q = p;
+        uint64_t header_n = 0;
+        read_number(&q, line_end, &header_n);
+        read_number(&q, line_end, &header_m);
+        p = line_end;
+        break;
+    }
+
+    // like readin(), the edge list ends at the first empty line
+    const char* body_end = p;
+    while (body_end < end && *body_end != '\n' && !(*body_end == '\r' && body_end + 1 < end && body_end[1] == '\n')) {
+        body_end = next_line(body_end, end);
+    }
+
+    std::vector<Chunk> chunks = split_chunks(p, body_end, threads, header_m);
+    run_parallel(threads, [&](unsigned long t) { parse_chunk(&chunks[t]); });
+
+    // global ids in order of first appearance
+    LabelMap global;
+    std::vector<LabelRef> labels;
+    for (Chunk& chunk: chunks) {
+        chunk.remap.resize(chunk.labels.size());
+        for (uint32_t i = 0; i < chunk.labels.size(); i++) {
+            auto ins = global.emplace(chunk.labels[i], (uint32_t) labels.size());
+            if (ins.second) labels.push_back(chunk.labels[i]);
+            chunk.remap[i] = ins.first->second;
+        }
+    }
+
+    Csr csr = build_csr(chunks, labels.size(), threads);
+    csr.labels.reserve(csr.n);
+    for (const LabelRef& label: labels) csr.labels.emplace_back(label.p, label.len);
+    return csr;
+}
+
+
+static Csr read_numbered(const char* data, unsigned long size, unsigned long threads, const std::string& format,
+                         std::string* error) {
+    const char* end = data + size;
+    const char* p = data;
+
+    // header: "p <kind> n m" for dimacs and pace, "n m [fmt [ncon]]" for metis
+    uint64_t n = 0, m = 0, fmt = 0, ncon = 0;
+    while (p < end) {
+        const char* line_end = next_line(p, end);
+        const char* q = p;
+        p = line_end;
+        while (q < line_end && is_space(*q)) q++;
+        if (format == "metis") {
+            if (!is_metis_vertex_line(q, line_end) || q == line_end || *q == '\n') continue;
+            read_number(&q, line_end, &n);
+            read_number(&q, line_end, &m);
+            // fmt is three binary digits: vertex size, vertex weights, edge weights
+            const char* r = q;
+            read_number(&r, line_end, &fmt);
+            if (fmt / 10 % 10 == 1) ncon = 1;
+            read_number(&r, line_end, &ncon);
+            if (count_tokens(r, line_end) > 0) {
+                if (error) *error = "metis header is not \"n m [fmt [ncon]]\"";
+                return Csr();
+            }
+            break;
+        }
+        if (q < line_end && *q == 'p') {
+            LabelRef token;
+            q = read_token(read_token(q, line_end, &token), line_end, &token);
+            read_number(&q, line_end, &n);
+            read_number(&q, line_end, &m);
+            break;
+        }
+    }
+    if (threads < 1) threads = 1;
+
+    std::vector<Chunk> chunks = split_chunks(p, end, threads, m);
+    if (format == "metis") {
+        // vertex of the first line of every chunk
+        std::vector<uint64_t> lines(threads, 0);
+        run_parallel(threads, [&](unsigned long t) {
+            for (const char* r = chunks[t].begin; r < chunks[t].end; r = next_line(r, chunks[t].end)) {
+                lines[t] += is_metis_vertex_line(r, next_line(r, chunks[t].end));
+            }
+        });
+        for (unsigned long t = 1; t < threads; t++) chunks[t].first_vertex = chunks[t - 1].first_vertex + lines[t - 1];
+        unsigned long vertex_numbers = (fmt / 100 % 10 == 1) + (fmt / 10 % 10 == 1 ? ncon : 0);
+        run_parallel(threads, [&](unsigned long t) { parse_metis_chunk(&chunks[t], vertex_numbers, fmt % 10 == 1); });
+    } else {
+        run_parallel(threads, [&](unsigned long t) { parse_edge_chunk(&chunks[t], format == "dimacs"); });
+    }
+
+    for (const Chunk& chunk: chunks) n = std::max(n, chunk.max_id);
+    Csr csr = build_csr(chunks, n, threads);
+    csr.labels.reserve(csr.n);
+    for (uint32_t v = 0; v < csr.n; v++) csr.labels.push_back(std::to_string(v + 1));
+    drop_isolated(&csr);
+    return csr;
+}
+
+
+Csr csr_read(const char* data, unsigned long size, unsigned long threads, const std::string& format,
+             std::string* error) {
+    // every driver (solver, lift, batch) reads through here, readin() is unused
+    STATS_TIMER(PHASE_READ);
+    if (threads < 1) threads = 1;
+    std::string kind = format == "auto" ? sniff_format(data, size) : format;
+    if (kind.empty()) {
+        if (error) *error = "input reads as pairs and as metis: pass --format";
+        return Csr();
+    }
+    if (kind == "pairs") return read_pairs(data, size, threads);
+    return read_numbered(data, size, threads, kind, error);
+}
@@ -0,0 +1,72 @@
+/*
+ *
+ * Fast input reading.
+ * The whole input is mapped (or read) into memory once and parsed
+ * straight into a Csr, in parallel if asked for:
+ *
+ * 1. split the edge lines into one chunk per thread at newline boundaries
+ * 2. every thread parses and interns the labels of its chunk
+ * 3. local ids are merged into global ids in order of first appearance,
+ *    which is the same order readin() assigns
+ * 4. degrees are counted into per thread histograms
+ * 5. adjacency is filled by prefix sum, then every list is sorted
+ *    and parallel edges are removed. Self-loops become forced nodes.
+ *    Before that one pass over the edges in input order grows a greedy
+ *    maximal matching (csr.matching).
+ *
+ * Formats (all share the tokenizer, chunking and steps 4 and 5):
+ * - pairs:  "n m", then one "a b" label pair per edge ('#' comments),
+ *           the format of vc/in
+ * - dimacs: "p edge n m", then "e u v" lines ('c' comments)
+ * - pace:   "p td n m", then "u v" lines ('c' comments), the .gr format
+ * - metis:  "n m [fmt [ncon]]", then line i lists the neighbours of
+ *           vertex i ('%' comments)
+ * Numbered formats keep their ids (1-based) as labels, vertices
+ * without edges are dropped like in the pairs format.
+ *
+ */
+
+#ifndef PP_AE_VC_READER_H
+#define PP_AE_VC_READER_H
+
+#include <string>
+
+#include "csr.h"
+
+
+typedef struct __input_buffer {
+    const char* data = nullptr;
+    unsigned long size = 0;
+    void* mapping = nullptr;   // set if data is mmapped
+    std::string owned;         // used if fd can not be mapped (pipes)
+} InputBuffer;
+
+
+/*
+ * Maps a regular file, otherwise reads fd until EOF.
+ */
+void input_open(InputBuffer* input, int fd = 0);
+
+void input_close(InputBuffer* input);
+
+/*
+ * Guesses the format from the header: a "p" line is dimacs (edge, col)
+ * or pace, '%' comments or a third header number mean metis. Between
+ * pairs and metis the token count of the first lines and the line count
+ * (n for metis, m for pairs) decide. If both are equal and every line
+ * has two tokens, the lines are checked for metis symmetry. Returns ""
+ * if the input is still ambiguous after that.
+ */
+std::string sniff_format(const char* data, unsigned long size);
+
+/*
+ * Parses the input into a Csr, format is "auto" (sniffed) or one of the above.
+ * Parallel edges are dropped, nodes with a self-loop go into csr.forced.
+ * If format is "auto" and the input is ambiguous, an empty Csr is
+ * returned and *error (if given) says so.
+ */
+Csr csr_read(const char* data, unsigned long size, unsigned long threads, const std::string& format = "auto",
+             std::string* error = nullptr);
+
+
+#endif //PP_AE_VC_READER_H
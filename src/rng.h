@@ -0,0 +1,39 @@
+/*
+ *
+ * Pseudo random numbers.
+ * xoshiro256** seeded with splitmix64. Every thread owns its own Rng,
+ * all randomized code takes one as argument. Same seed, same run.
+ *
+ */
+
+#ifndef PP_AE_VC_RNG_H
+#define PP_AE_VC_RNG_H
+
+#include <cstdint>
+
+
+typedef struct __rng {
+    uint64_t s[4];
+} Rng;
+
+
+/*
+ * Seeds the generator. stream separates the generators of several
+ * threads that share one seed, e.g. the thread index.
+ */
+void rng_seed(Rng* rng, uint64_t seed, uint64_t stream = 0);
+
+uint64_t rng_next(Rng* rng);
+
+/*
+ * Uniform number in [0, bound). bound must not be 0.
+ */
+uint64_t rng_below(Rng* rng, uint64_t bound);
+
+/*
+ * Seed from std::random_device, for runs without --seed.
+ */
+uint64_t rng_random_seed();
+
+
+#endif //PP_AE_VC_RNG_H
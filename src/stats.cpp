@@ -0,0 +1,101 @@
+#include "stats.h"
+
+#include <iostream>
+#include <mutex>
+#include <algorithm>
+
+
+#ifdef VC_STATS
+thread_local ThreadStats vc_stats;
+
+typedef struct __stats_registry {
+    std::mutex lock;
+    std::vector<const Stats*> live;   // copies of running threads
+    Stats total;                      // merged copies of exited threads
+} StatsRegistry;
+
+
+static StatsRegistry* registry() {
+    static StatsRegistry r;
+    return &r;
+}
+
+
+static void stats_add(Stats* into, const Stats& from) {
+    into->bucket_removals += from.bucket_removals;
+    into->bucket_erases += from.bucket_erases;
+    into->erase_calls += from.erase_calls;
+    into->deg_zero_sweeps += from.deg_zero_sweeps;
+    into->deleted_deg_one += from.deleted_deg_one;
+    into->deleted_deg_zero += from.deleted_deg_zero;
+    into->deleted_max_deg += from.deleted_max_deg;
+    into->deleted_clique += from.deleted_clique;
+    into->deleted_cycle += from.deleted_cycle;
+    into->pruned_redundant += from.pruned_redundant;
+    into->bnb_probe_prunes += from.bnb_probe_prunes;
+    into->hk_paths.insert(into->hk_paths.end(), from.hk_paths.begin(), from.hk_paths.end());
+    into->ls_flips += from.ls_flips;
+    for (int p = 0; p < PHASE_COUNT; p++) into->phase_ns[p] += from.phase_ns[p];
+}
+
+
+ThreadStats::ThreadStats() {
+    StatsRegistry* r = registry();
+    std::lock_guard<std::mutex> guard(r->lock);
+    r->live.push_back(this);
+}
+
+
+ThreadStats::~ThreadStats() {
+    StatsRegistry* r = registry();
+    std::lock_guard<std::mutex> guard(r->lock);
+    r->live.erase(std::find(r->live.begin(), r->live.end(), this));
+    stats_add(&r->total, *this);
+}
+
+static const char* phase_names[PHASE_COUNT] = {
+        "read", "deg_one", "max_deg_heur", "clique_cover_lb", "lpb", "cycle_bound", "local_search", "output"
+};
+#endif
+
+
+void stats_print(std::ostream& out) {
+#ifdef VC_STATS
+    // all workers are joined by now, the live copies are not written to
+    Stats s;
+    {
+        StatsRegistry* r = registry();
+        std::lock_guard<std::mutex> guard(r->lock);
+        s = r->total;
+        for (const Stats* live: r->live) stats_add(&s, *live);
+    }
+    out << "stats"
+        << " bucket_removals=" << s.bucket_removals
+        << " bucket_erases=" << s.bucket_erases
+        << " erase_calls=" << s.erase_calls
+        << " deg_zero_sweeps=" << s.deg_zero_sweeps
+        << " deleted_deg_one=" << s.deleted_deg_one
+        << " deleted_deg_zero=" << s.deleted_deg_zero
+        << " deleted_max_deg=" << s.deleted_max_deg
+        << " deleted_clique=" << s.deleted_clique
+        << " deleted_cycle=" << s.deleted_cycle
+        << " pruned_redundant=" << s.pruned_redundant
+        << " bnb_probe_prunes=" << s.bnb_probe_prunes
+        << " hk_phases=" << s.hk_paths.size()
+        << " hk_paths=";
+    for (unsigned long i = 0; i < s.hk_paths.size(); i++) {
+        if (i) out << "/";
+        out << s.hk_paths[i];
+    }
+    if (s.hk_paths.empty()) out << "0";
+    out << " ls_flips=" << s.ls_flips;
+    double ls_seconds = s.phase_ns[PHASE_LOCAL_SEARCH] / 1e9;
+    out << " ls_flips_per_s=" << (ls_seconds > 0 ? s.ls_flips / ls_seconds : 0.0);
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        out << " ns_" << phase_names[p] << "=" << s.phase_ns[p];
+    }
+    out << std::endl;
+#else
+    out << "stats disabled: rebuild with -DVC_STATS=ON" << std::endl;
+#endif
+}
@@ -0,0 +1,113 @@
+/*
+ *
+ * Hot path instrumentation.
+ * Counters and scoped phase timers for --stats.
+ * Only compiled in with -DVC_STATS=ON (cmake option VC_STATS).
+ * Without it every macro expands to nothing, so the hot paths
+ * stay exactly as fast as before.
+ * Counters are per thread. Every thread's copy is registered and
+ * merged into a process total when the thread exits, so the report
+ * covers the race, bnb, batch and lower bound workers too. Phase
+ * times are summed over threads (CPU time, not wall time).
+ *
+ */
+
+#ifndef PP_AE_VC_STATS_H
+#define PP_AE_VC_STATS_H
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+
+
+enum StatsPhase {
+    PHASE_READ,
+    PHASE_DEG_ONE,
+    PHASE_MAX_DEG,
+    PHASE_CLIQUE_LB,
+    PHASE_LP_LB,
+    PHASE_CYCLE_LB,
+    PHASE_LOCAL_SEARCH,
+    PHASE_OUTPUT,
+    PHASE_COUNT
+};
+
+
+typedef struct __stats {
+    // node taken out of its degree bucket of node_degree_map (deleted or
+    // about to move to another bucket)
+    unsigned long bucket_removals = 0;
+    // degree bucket that became empty and was erased from node_degree_map
+    unsigned long bucket_erases = 0;
+    unsigned long erase_calls = 0; // delete_node_erase
+    unsigned long deg_zero_sweeps = 0;
+
+    // deleted vertices per rule
+    unsigned long deleted_deg_one = 0;
+    unsigned long deleted_deg_zero = 0;
+    unsigned long deleted_max_deg = 0;
+    unsigned long deleted_clique = 0;
+    unsigned long deleted_cycle = 0;
+
+    // redundant cover nodes removed after the upper bound
+    unsigned long pruned_redundant = 0;
+
+    // branches of the exact search cut by probing
+    unsigned long bnb_probe_prunes = 0;
+
+    // augmenting paths found per Hopcroft-Karp phase
+    std::vector<unsigned long> hk_paths;
+
+    unsigned long ls_flips = 0;
+
+    unsigned long long phase_ns[PHASE_COUNT] = {};
+} Stats;
+
+
+#ifdef VC_STATS
+
+struct ThreadStats : Stats {
+    ThreadStats();
+    ~ThreadStats();
+};
+
+extern thread_local ThreadStats vc_stats;
+
+class StatsTimer {
+public:
+    explicit StatsTimer(StatsPhase phase) : phase(phase), start(std::chrono::steady_clock::now()) {}
+    ~StatsTimer() {
+        vc_stats.phase_ns[phase] += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+    }
+private:
+    StatsPhase phase;
+    std::chrono::steady_clock::time_point start;
+};
+
+#define STATS_CAT_(a, b) a##b
+#define STATS_CAT(a, b) STATS_CAT_(a, b)
+#define STATS_INC(counter) (vc_stats.counter++)
+#define STATS_ADD(counter, value) (vc_stats.counter += (value))
+#define STATS_PUSH(counter, value) (vc_stats.counter.push_back(value))
+#define STATS_TIMER(phase) StatsTimer STATS_CAT(stats_timer_, __LINE__)(phase)
+
+#else
+
+#define STATS_INC(counter) ((void) 0)
+#define STATS_ADD(counter, value) ((void) 0)
+#define STATS_PUSH(counter, value) ((void) 0)
+#define STATS_TIMER(phase) ((void) 0)
+
+#endif
+
+
+/*
+ * Writes all counters and timers as one line of key=value pairs.
+ * The checker stores stderr in a csv column, so there are no commas.
+ * Prints a notice instead if the binary was built without VC_STATS.
+ */
+void stats_print(std::ostream& out);
+
+
+#endif //PP_AE_VC_STATS_H
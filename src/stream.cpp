@@ -0,0 +1,268 @@
+#include "stream.h"
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "out.h"
+
+
+static const unsigned long BLOCK = 1 << 20;
+
+enum : char { ALIVE = 0, TAKEN = 1, DROPPED = 2 };
+
+
+typedef struct __stream_state {
+    std::unordered_map<std::string, uint32_t> ids;
+    std::vector<std::string>* labels;
+    std::vector<uint32_t> degree;
+    std::vector<char> state;
+    std::vector<char> matched;
+    FILE* spool = nullptr;
+    std::vector<uint32_t> pending;    // spool write buffer
+    bool failed = false;              // a spool write or read failed
+} StreamState;
+
+
+static uint32_t intern(StreamState* s, const char* p, unsigned long len) {
+    auto ins = s->ids.emplace(std::string(p, len), (uint32_t) s->labels->size());
+    if (ins.second) {
+        s->labels->push_back(ins.first->first);
+        s->degree.push_back(0);
+        s->state.push_back(ALIVE);
+        s->matched.push_back(0);
+    }
+    return ins.first->second;
+}
+
+
+static void spool_flush(StreamState* s) {
+    if (!s->pending.empty() &&
+        fwrite(s->pending.data(), sizeof(uint32_t), s->pending.size(), s->spool) != s->pending.size()) {
+        s->failed = true;
+    }
+    s->pending.clear();
+}
+
+
+static void spool_edge(StreamState* s, uint32_t a, uint32_t b) {
+    s->pending.push_back(a);
+    s->pending.push_back(b);
+    if (s->pending.size() * sizeof(uint32_t) >= BLOCK) spool_flush(s);
+}
+
+
+/*
+ * Calls f(a, b) for every spooled edge, reading BLOCK bytes at a time.
+ * Returns the number of edges read, s->failed is set on a read error.
+ */
+template<typename F>
+static unsigned long stream_edges(StreamState* s, F f) {
+    std::vector<uint32_t> buf(BLOCK / sizeof(uint32_t));
+    rewind(s->spool);
+    unsigned long r, edges = 0;
+    while ((r = fread(buf.data(), sizeof(uint32_t), buf.size(), s->spool)) > 0) {
+        for (unsigned long i = 0; i + 1 < r; i += 2) f(buf[i], buf[i + 1]);
+        edges += r / 2;
+    }
+    if (ferror(s->spool)) s->failed = true;
+    return edges;
+}
+
+
+static bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+
+/*
+ * One edge line. Returns false at the empty line that ends the edge list.
+ */
+static bool parse_line(StreamState* s, const char* p, const char* end, bool* header, StreamResult* result) {
+    if (p < end && *p == '#') return true;
+    const char* tokens[2];
+    unsigned long lens[2];
+    int count = 0;
+    while (p < end && count < 2) {
+        while (p < end && is_space(*p)) p++;
+        const char* start = p;
+        while (p < end && !is_space(*p)) p++;
+        if (p == start) break;
+        tokens[count] = start;
+        lens[count++] = p - start;
+    }
+    if (*header) {
+        if (count > 0) *header = false;
+        return true;
+    }
+    if (count == 0) return false;
+    if (count < 2) return true;
+
+    uint32_t a = intern(s, tokens[0], lens[0]);
+    uint32_t b = intern(s, tokens[1], lens[1]);
+    if (a == b) {
+        s->state[a] = TAKEN;
+        return true;
+    }
+    spool_edge(s, a, b);
+    result->m++;
+    s->degree[a]++;
+    s->degree[b]++;
+    if (!s->matched[a] && !s->matched[b]) {
+        s->matched[a] = s->matched[b] = 1;
+        result->matching++;
+    }
+    return true;
+}
+
+
+/*
+ * Returns false if the spool could not be written completely.
+ */
+static bool parse_input(StreamState* s, int fd, StreamResult* result) {
+    std::vector<char> buf(BLOCK);
+    std::string carry;
+    bool header = true;
+    bool body = true;
+    ssize_t r;
+    while (body && (r = read(fd, buf.data(), buf.size())) > 0) {
+        const char* p = buf.data();
+        const char* end = p + r;
+        while (body && p < end) {
+            const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (!nl) {
+                carry.append(p, end - p);
+                break;
+            }
+            if (!carry.empty()) {
+                carry.append(p, nl - p);
+                body = parse_line(s, carry.data(), carry.data() + carry.size(), &header, result);
+                carry.clear();
+            } else {
+                body = parse_line(s, p, nl, &header, result);
+            }
+            p = nl + 1;
+        }
+    }
+    if (body && !carry.empty()) parse_line(s, carry.data(), carry.data() + carry.size(), &header, result);
+    spool_flush(s);
+    if (fflush(s->spool) != 0 || ferror(s->spool)) s->failed = true;
+    return !s->failed;
+}
+
+
+static void recount(StreamState* s, StreamResult* result) {
+    std::fill(s->degree.begin(), s->degree.end(), 0);
+    stream_edges(s, [&](uint32_t a, uint32_t b) {
+        if (s->state[a] != ALIVE || s->state[b] != ALIVE) return;
+        s->degree[a]++;
+        s->degree[b]++;
+    });
+    result->passes++;
+}
+
+
+/*
+ * Takes the neighbour of every degree one node. Degrees are from the last
+ * recount and only got smaller since, so a node with degree one and an
+ * alive neighbour really has just that neighbour.
+ */
+static bool degree_one_pass(StreamState* s, StreamResult* result) {
+    bool changed = false;
+    stream_edges(s, [&](uint32_t a, uint32_t b) {
+        if (s->state[a] != ALIVE || s->state[b] != ALIVE) return;
+        if (s->degree[a] == 1) std::swap(a, b);
+        if (s->degree[b] != 1) return;
+        s->state[a] = TAKEN;
+        s->state[b] = DROPPED;
+        changed = true;
+    });
+    result->passes++;
+    return changed;
+}
+
+
+bool stream_cover(int fd, unsigned long passes, const std::string& kernel_path, StreamResult* result) {
+    StreamState s;
+    s.labels = &result->labels;
+    s.spool = tmpfile();
+    if (!s.spool) return false;
+
+    if (!parse_input(&s, fd, result)) {
+        fclose(s.spool);
+        return false;
+    }
+    result->n = result->labels.size();
+    std::unordered_map<std::string, uint32_t>().swap(s.ids);
+
+    for (unsigned long i = 0; i < passes && !s.failed; i++) {
+        recount(&s, result);
+        if (!degree_one_pass(&s, result)) break;
+    }
+    recount(&s, result);
+
+    for (uint32_t v = 0; v < result->n; v++) {
+        if (s.state[v] == TAKEN) {
+            result->cover.push_back(v);
+            result->taken++;
+        } else if (s.state[v] == ALIVE && s.degree[v] > 0) {
+            result->kernel_n++;
+            result->kernel_m += s.degree[v];
+        }
+    }
+    result->kernel_m /= 2;
+
+    Out out;
+    bool write_kernel = !kernel_path.empty();
+    if (write_kernel) {
+        int fd_kernel = open(kernel_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd_kernel < 0) {
+            fclose(s.spool);
+            return false;
+        }
+        out_open(&out, fd_kernel);
+        out_ul(&out, result->kernel_n);
+        out_char(&out, ' ');
+        out_ul(&out, result->kernel_m);
+        out_char(&out, '\n');
+    }
+
+    // kernel edges, matched greedily. Every edge has to end up covered:
+    // edges out of the kernel by a taken endpoint, kernel edges by the
+    // matching. All m edges have to come back from the spool, otherwise
+    // the cover is not valid
+    std::fill(s.matched.begin(), s.matched.end(), 0);
+    bool covered = true;
+    unsigned long spooled = stream_edges(&s, [&](uint32_t a, uint32_t b) {
+        if (s.state[a] != ALIVE || s.state[b] != ALIVE) {
+            if (s.state[a] != TAKEN && s.state[b] != TAKEN) covered = false;
+            return;
+        }
+        if (write_kernel) {
+            out_string(&out, result->labels[a]);
+            out_char(&out, ' ');
+            out_string(&out, result->labels[b]);
+            out_char(&out, '\n');
+        }
+        if (!s.matched[a] && !s.matched[b]) {
+            s.matched[a] = s.matched[b] = 1;
+            result->cover.push_back(a);
+            result->cover.push_back(b);
+        }
+        if (!s.matched[a] && !s.matched[b]) covered = false;
+    });
+    result->passes++;
+    fclose(s.spool);
+
+    if (write_kernel) {
+        out_str(&out, "#difference: ", 13);
+        out_ul(&out, result->taken);
+        out_char(&out, '\n');
+        out_close(&out);
+        if (close(out.fd) != 0 || out.failed) return false;
+    }
+    return covered && spooled == result->m && !s.failed;
+}
@@ -0,0 +1,54 @@
+/*
+ *
+ * Semi-external mode for graphs whose edges do not fit in memory.
+ * Only O(n) vertex state is kept in RAM (labels, degree, state, matched).
+ * The edges are parsed once from the input (a pipe is fine) and spooled
+ * as binary id pairs to a temporary file, later passes stream that file
+ * with a fixed size buffer:
+ *
+ * 1. parse: intern labels, count degrees, self-loop nodes are taken,
+ *    greedy maximal matching on the fly (its size is a lower bound)
+ * 2. repeat up to passes times: recount degrees of the remaining graph,
+ *    then take the neighbour of every degree one node
+ * 3. recount, then a last pass writes the kernel (remaining edges) and
+ *    matches it greedily; the cover is all taken nodes plus both
+ *    endpoints of every kernel matching edge (2-approximation on the kernel)
+ *
+ * Input is the "n m" + label pair format.
+ *
+ */
+
+#ifndef PP_AE_VC_STREAM_H
+#define PP_AE_VC_STREAM_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+typedef struct __stream_result {
+    std::vector<std::string> labels;   // id -> label
+    std::vector<uint32_t> cover;
+    unsigned long n = 0;
+    unsigned long m = 0;               // edges without self-loops, as read
+    unsigned long matching = 0;        // size of the pass 1 matching, a lower bound
+    unsigned long taken = 0;           // nodes fixed by self-loops and degree one
+    unsigned long passes = 0;          // passes over the spool
+    unsigned long kernel_n = 0;
+    unsigned long kernel_m = 0;
+} StreamResult;
+
+
+/*
+ * Runs the semi-external pipeline on the graph read from fd.
+ * If kernel_path is not empty, the kernel is written there in the
+ * input format, followed by "#difference: taken".
+ * Returns false if the spool or the kernel file can not be created, if
+ * a spool or kernel write or a spool read fails (e.g. ENOSPC) or if the
+ * final pass finds an edge the cover misses. The cover (or the kernel)
+ * is not valid then.
+ */
+bool stream_cover(int fd, unsigned long passes, const std::string& kernel_path, StreamResult* result);
+
+
+#endif //PP_AE_VC_STREAM_H
@@ -0,0 +1,62 @@
+#include "trace.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "out.h"
+
+
+Trace* vc_trace = nullptr;
+
+
+void trace_open(unsigned long capacity) {
+    delete vc_trace;
+    vc_trace = new Trace();
+    vc_trace->events.resize(capacity > 0 ? capacity : 1);
+    vc_trace->start = std::chrono::steady_clock::now();
+}
+
+
+void trace_record(unsigned long size, unsigned long lb, const char* phase) {
+    Trace* trace = vc_trace;
+    if (!trace) return;
+    unsigned long offset = trace->offset.load(std::memory_order_relaxed);
+    TraceEvent& event = trace->events[trace->next.fetch_add(1, std::memory_order_relaxed) % trace->events.size()];
+    event.ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - trace->start).count();
+    event.size = size == ULONG_MAX ? ULONG_MAX : size + offset;
+    event.lb = lb + offset;
+    event.phase = phase;
+}
+
+
+bool trace_dump(const std::string& path) {
+    Trace* trace = vc_trace;
+    if (!trace) return true;
+    vc_trace = nullptr;
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        delete trace;
+        return false;
+    }
+
+    Out out;
+    out_open(&out, fd);
+    out_str(&out, "ns,size,lb,phase\n", 17);
+    unsigned long count = trace->next.load();
+    unsigned long capacity = trace->events.size();
+    for (unsigned long i = count > capacity ? count - capacity : 0; i < count; i++) {
+        const TraceEvent& event = trace->events[i % capacity];
+        out_ul(&out, event.ns);
+        out_char(&out, ',');
+        if (event.size != ULONG_MAX) out_ul(&out, event.size);
+        out_char(&out, ',');
+        out_ul(&out, event.lb);
+        out_char(&out, ',');
+        out_str(&out, event.phase, std::char_traits<char>::length(event.phase));
+        out_char(&out, '\n');
+    }
+    out_close(&out);
+    close(fd);
+    delete trace;
+    return true;
+}
@@ -0,0 +1,69 @@
+/*
+ *
+ * Quality over time trace for the anytime modes.
+ * Every time the best cover or the lower bound improves, an event
+ * (time since trace_open, cover size, lower bound, phase) is written
+ * into a ring buffer that is allocated up front. Recording is a relaxed
+ * fetch_add and four stores, no allocation and no I/O, so tracing does
+ * not change the timing it measures. When the buffer is full the oldest
+ * events are overwritten.
+ * Sizes and bounds are recorded for the input graph: the pipeline sets
+ * the offset of the nodes the reductions took (trace_set_offset) and
+ * kernel values are shifted by it.
+ * The trace is dumped as csv on exit (--trace FILE). It is process wide,
+ * meant for runs on a single instance (not --batch).
+ *
+ */
+
+#ifndef PP_AE_VC_TRACE_H
+#define PP_AE_VC_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <string>
+#include <vector>
+
+
+typedef struct __trace_event {
+    unsigned long long ns;
+    unsigned long size;        // ULONG_MAX: no cover yet
+    unsigned long lb;
+    const char* phase;         // string literal
+} TraceEvent;
+
+
+typedef struct __trace {
+    std::vector<TraceEvent> events;          // ring, size is the capacity
+    std::atomic<unsigned long> next{0};      // events recorded so far
+    std::atomic<unsigned long> offset{0};    // nodes fixed by the reductions
+    std::chrono::steady_clock::time_point start;
+} Trace;
+
+
+extern Trace* vc_trace;   // nullptr unless trace_open was called
+
+
+/*
+ * Starts tracing with room for capacity events, the clock starts now.
+ */
+void trace_open(unsigned long capacity = 1 << 16);
+
+inline void trace_set_offset(unsigned long offset) {
+    if (vc_trace) vc_trace->offset.store(offset, std::memory_order_relaxed);
+}
+
+/*
+ * Records an event, size and lb are for the kernel (the offset is added).
+ * Does nothing if tracing is off.
+ */
+void trace_record(unsigned long size, unsigned long lb, const char* phase);
+
+/*
+ * Writes "ns,size,lb,phase" rows, oldest first, and stops tracing.
+ * Returns false if path can not be written.
+ */
+bool trace_dump(const std::string& path);
+
+
+#endif //PP_AE_VC_TRACE_H
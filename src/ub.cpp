@@ -2,52 +2,162 @@
 
 #include "ub.h"
 #include "graph.h"
+#include "stats.h"
 
-#include <random>
 #include <stack>
+#include <vector>
+#include <algorithm>
 
 
 
 
 unsigned long max_deg_heur(Graph* graph, std::stack<bool*>* res_stack) {
+    STATS_TIMER(PHASE_MAX_DEG);
     unsigned long size = 0;
     while (!graph->node_degree_map.empty()) {
         // randomization?
         bool* node = *graph->node_degree_map.rbegin()->second.begin();
         res_stack->push(node);
         delete_node_erase(node, graph);
+        STATS_INC(deleted_max_deg);
         size++;
     }
     return size;
 }
 
 
-unsigned long max_deg_heur_rand(Graph* graph, std::stack<bool*>* res_stack) {
+unsigned long max_deg_heur_rand(Graph* graph, std::stack<bool*>* res_stack, Rng* rng) {
+    STATS_TIMER(PHASE_MAX_DEG);
     unsigned long size = 0;
-    while (!graph->node_degree_map.empty()) {
-        // randomization?
-
-        std::random_device rd;
-        std::mt19937 gen(rd());
-
-        std::set<bool*>* node_set = &graph->node_degree_map.rbegin()->second;
 
-        std::uniform_int_distribution<> dis(0, node_set->size() - 1);
-        int rand_i = dis(gen);
-        auto iter = node_set->begin();
-        std::advance(iter, rand_i);
+    // array backed copy of node_degree_map, a random node of a bucket is O(1)
+    Buckets buckets;
+    unsigned long max_degree = graph->node_degree_map.empty() ? 0 : graph->node_degree_map.rbegin()->first;
+    buckets_init(&buckets, graph->n, max_degree);
+    for (const auto& entry: graph->node_degree_map) {
+        for (bool* node: entry.second) {
+            buckets_insert(&buckets, node_id(node, graph), entry.first);
+        }
+    }
 
-        bool* node = *iter;
+    while (buckets.size > 0) {
+        std::vector<unsigned long>& bucket = buckets.nodes[buckets_max_degree(&buckets)];
+        bool* node = &graph->indicators[bucket[rng_below(rng, bucket.size())]];
 
         res_stack->push(node);
+        buckets_remove(&buckets, node_id(node, graph));
         delete_node_erase(node, graph);
+        STATS_INC(deleted_max_deg);
         size++;
+
+        // the set of node still holds the neighbours it had before the erase
+        for (bool* neighbour: get_node_neighbours(node, graph)) {
+            unsigned long id = node_id(neighbour, graph);
+            if (!buckets.present[id]) continue;
+            if (*neighbour) buckets_set_degree(&buckets, id, get_node_degree(neighbour, graph));
+            else buckets_remove(&buckets, id); // removed by deg_zero
+        }
     }
     return size;
 }
 
 
 
+template<typename G>
+static std::vector<uint32_t> mis_impl(const G* csr) {
+    unsigned long n = csr->n;
+    std::vector<uint64_t> alive((n + 63) / 64, ~(uint64_t) 0);
+    if (n % 64) alive.back() = ((uint64_t) 1 << (n % 64)) - 1;
+    std::vector<uint64_t> independent((n + 63) / 64, 0);
+    auto is_alive = [&](uint32_t v) { return (alive[v >> 6] >> (v & 63)) & 1; };
+
+    // degree bins with lazy entries: a node is pushed again whenever its
+    // degree drops, stale entries are skipped when popped
+    std::vector<uint32_t> degree(n);
+    uint32_t max_degree = 0;
+    for (uint32_t v = 0; v < n; v++) {
+        degree[v] = degree_of(csr, v);
+        max_degree = std::max(max_degree, degree[v]);
+    }
+    std::vector<std::vector<uint32_t>> bins(max_degree + 1);
+    for (uint32_t v = n; v > 0; v--) bins[degree[v - 1]].push_back(v - 1);
+
+    uint32_t min_degree = 0;
+    while (min_degree <= max_degree) {
+        if (bins[min_degree].empty()) {
+            min_degree++;
+            continue;
+        }
+        uint32_t v = bins[min_degree].back();
+        bins[min_degree].pop_back();
+        if (!is_alive(v) || degree[v] != min_degree) continue;
+
+        independent[v >> 6] |= (uint64_t) 1 << (v & 63);
+        alive[v >> 6] &= ~((uint64_t) 1 << (v & 63));
+        for_each_neighbour(csr, v, [&](uint32_t u) {
+            if (!is_alive(u)) return true;
+            alive[u >> 6] &= ~((uint64_t) 1 << (u & 63));
+            for_each_neighbour(csr, u, [&](uint32_t w) {
+                if (!is_alive(w)) return true;
+                degree[w]--;
+                bins[degree[w]].push_back(w);
+                min_degree = std::min(min_degree, degree[w]);
+                return true;
+            });
+            return true;
+        });
+    }
+
+    std::vector<uint32_t> cover;
+    cover.reserve(n);
+    for (unsigned long word = 0; word < independent.size(); word++) {
+        uint64_t bits = ~independent[word];
+        if (word + 1 == independent.size() && n % 64) bits &= ((uint64_t) 1 << (n % 64)) - 1;
+        while (bits) {
+            cover.push_back(word * 64 + __builtin_ctzll(bits));
+            bits &= bits - 1;
+        }
+    }
+    return cover;
+}
+
+
+std::vector<uint32_t> ub_min_degree_mis(const Csr* csr) {
+    return mis_impl(csr);
+}
+
+
+std::vector<uint32_t> ub_min_degree_mis(const PackedCsr* csr) {
+    return mis_impl(csr);
+}
+
+
+std::vector<uint32_t> ub_matching(const Csr* csr) {
+    std::vector<char> matched(csr->n, 0);
+    std::vector<uint32_t> cover;
+    for (uint32_t v = 0; v < csr->n; v++) {
+        if (matched[v]) continue;
+        for (uint64_t i = csr->offsets[v]; i < csr->offsets[v + 1]; i++) {
+            uint32_t u = csr->adj[i];
+            if (matched[u]) continue;
+            matched[v] = matched[u] = 1;
+            cover.push_back(v);
+            cover.push_back(u);
+            break;
+        }
+    }
+    return cover;
+}
+
+
+std::vector<uint32_t> ub_read_matching(const Csr* csr) {
+    std::vector<uint32_t> cover(csr->forced);
+    cover.insert(cover.end(), csr->matching.begin(), csr->matching.end());
+    return cover;
+}
+
+
 void local_search(Graph* graph) {
+    STATS_TIMER(PHASE_LOCAL_SEARCH);
 
 }
\ No newline at end of file
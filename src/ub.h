@@ -1,11 +1,41 @@
 #include <stack>
 #include "graph.h"
+#include "rng.h"
+#include "buckets.h"
+#include "csr.h"
+#include "packed.h"
 
 #ifndef PP_AE_VC_UB_H
 #define PP_AE_VC_UB_H
 
 unsigned long max_deg_heur(Graph* graph, std::stack<bool*>* res_stack);
 
-unsigned long max_deg_heur_rand(Graph* graph, std::stack<bool*>* res_stack);
+/*
+ * Like max_deg_heur, but picks a uniformly random node among all
+ * nodes of maximum degree. Reproducible for a fixed rng seed.
+ */
+unsigned long max_deg_heur_rand(Graph* graph, std::stack<bool*>* res_stack, Rng* rng);
+
+/*
+ * Grows a maximal independent set, always taking a node of minimum
+ * degree in the remaining graph, and returns its complement.
+ * Alive flags are a bitset, taking a node clears the bit of each of
+ * its neighbours.
+ */
+std::vector<uint32_t> ub_min_degree_mis(const Csr* csr);
+
+std::vector<uint32_t> ub_min_degree_mis(const PackedCsr* csr);
+
+/*
+ * Both endpoints of a greedy maximal matching, a 2-approximation.
+ * One pass over the edges, no buckets.
+ */
+std::vector<uint32_t> ub_matching(const Csr* csr);
+
+/*
+ * The cover the reader left in csr: forced nodes and both endpoints
+ * of csr->matching. Free, as the matching was grown while parsing.
+ */
+std::vector<uint32_t> ub_read_matching(const Csr* csr);
 
 #endif //PP_AE_VC_UB_H
@@ -0,0 +1,58 @@
+#include "verify.h"
+
+#include "stats.h"
+
+
+template<typename G>
+static bool verify_impl(const G* csr, const std::vector<uint32_t>& cover) {
+    std::vector<char> in_cover(csr->n, 0);
+    for (uint32_t v: cover) {
+        if (v >= csr->n) return false;
+        in_cover[v] = 1;
+    }
+    bool covered = true;
+    for (uint32_t v = 0; v < csr->n && covered; v++) {
+        if (in_cover[v]) continue;
+        covered = for_each_neighbour(csr, v, [&](uint32_t u) { return (bool) in_cover[u]; });
+    }
+    return covered;
+}
+
+
+template<typename G>
+static unsigned long prune_impl(const G* csr, std::vector<uint32_t>* cover) {
+    std::vector<char> in_cover(csr->n, 0);
+    for (uint32_t v: *cover) in_cover[v] = 1;
+
+    unsigned long kept = 0;
+    for (uint32_t v: *cover) {
+        bool redundant = for_each_neighbour(csr, v, [&](uint32_t u) { return (bool) in_cover[u]; });
+        if (redundant) in_cover[v] = 0;
+        else (*cover)[kept++] = v;
+    }
+
+    unsigned long removed = cover->size() - kept;
+    cover->resize(kept);
+    STATS_ADD(pruned_redundant, removed);
+    return removed;
+}
+
+
+bool verify_cover(const Csr* csr, const std::vector<uint32_t>& cover) {
+    return verify_impl(csr, cover);
+}
+
+
+bool verify_cover(const PackedCsr* csr, const std::vector<uint32_t>& cover) {
+    return verify_impl(csr, cover);
+}
+
+
+unsigned long prune_redundant(const Csr* csr, std::vector<uint32_t>* cover) {
+    return prune_impl(csr, cover);
+}
+
+
+unsigned long prune_redundant(const PackedCsr* csr, std::vector<uint32_t>* cover) {
+    return prune_impl(csr, cover);
+}
@@ -0,0 +1,35 @@
+/*
+ *
+ * Cover verification and minimality pruning on a Csr.
+ * Both are O(n + m) and run after every upper bound.
+ *
+ */
+
+#ifndef PP_AE_VC_VERIFY_H
+#define PP_AE_VC_VERIFY_H
+
+#include <vector>
+
+#include "csr.h"
+#include "packed.h"
+
+
+/*
+ * True if every edge of csr has an endpoint in cover.
+ */
+bool verify_cover(const Csr* csr, const std::vector<uint32_t>& cover);
+
+bool verify_cover(const PackedCsr* csr, const std::vector<uint32_t>& cover);
+
+/*
+ * Removes redundant nodes from cover: nodes whose neighbours are all
+ * in the cover. One pass is enough, removing a node only makes its
+ * neighbours necessary. The result is a minimal cover.
+ * Returns the number of removed nodes.
+ */
+unsigned long prune_redundant(const Csr* csr, std::vector<uint32_t>* cover);
+
+unsigned long prune_redundant(const PackedCsr* csr, std::vector<uint32_t>* cover);
+
+
+#endif //PP_AE_VC_VERIFY_H
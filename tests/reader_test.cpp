@@ -0,0 +1,123 @@
+/*
+ *
+ * Reader fixtures: every file in tests/reader is read with format
+ * sniffing and the result checked with verify_cover against a cover
+ * of the intended graph. Such a cover misses an edge if the file is
+ * read in the wrong format. The matching cover the reader leaves
+ * (forced plus both matching endpoints) has to be valid as well.
+ * Fixtures with read_error have to be rejected by csr_read.
+ *
+ * Usage: PP_AE_VC_reader_test <fixture dir>
+ *
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../src/reader.h"
+#include "../src/verify.h"
+
+
+typedef struct __fixture {
+    const char* file;
+    const char* format;           // sniffed format, "" if auto has to refuse
+    std::vector<std::string> cover;
+    bool read_error;
+} Fixture;
+
+
+static const std::vector<Fixture> fixtures = {
+        {"pairs.in",             "pairs",  {"b", "c", "e"}, false},
+        {"pairs_square.in",      "pairs",  {"1", "3"},      false},
+        // ends in a digit, no newline
+        {"pairs_no_newline.in",  "pairs",  {"2"},           false},
+        {"dimacs.in",            "dimacs", {"2", "3"},      false},
+        {"pace.in",              "pace",   {"2", "3"},      false},
+        {"metis.in",             "metis",  {"2", "3"},      false},
+        // 2-regular metis, the pairs reading repeats edges
+        {"metis_2regular.in",    "metis",  {"1", "3"},      false},
+        // the same with an isolated vertex, a blank last line
+        {"metis_isolated.in",    "metis",  {"1", "3"},      false},
+        {"metis_bad_header.in",  "metis",  {},              true},
+        // a 6-cycle as metis, two triangles as pairs
+        {"ambiguous.in",         "",       {"1", "3", "5"}, false},
+};
+
+
+static bool check_cover(const Csr* csr, const std::vector<std::string>& labels) {
+    std::vector<uint32_t> cover;
+    for (const std::string& label: labels) {
+        for (uint32_t v = 0; v < csr->n; v++) {
+            if (csr->labels[v] == label) cover.push_back(v);
+        }
+    }
+    return cover.size() == labels.size() && verify_cover(csr, cover);
+}
+
+
+static bool run_fixture(const std::string& dir, const Fixture& fixture) {
+    std::ifstream in(dir + "/" + fixture.file);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    std::string text = buffer.str();
+    if (text.empty()) {
+        std::cerr << fixture.file << ": can not read" << std::endl;
+        return false;
+    }
+
+    std::string sniffed = sniff_format(text.data(), text.size());
+    if (sniffed != fixture.format) {
+        std::cerr << fixture.file << ": sniffed \"" << sniffed << "\", expected \"" << fixture.format << "\"" << std::endl;
+        return false;
+    }
+
+    std::string error;
+    Csr csr = csr_read(text.data(), text.size(), 1, "auto", &error);
+    if (fixture.read_error) {
+        if (error.empty()) {
+            std::cerr << fixture.file << ": invalid input was read" << std::endl;
+            return false;
+        }
+        return true;
+    }
+    if (sniffed.empty()) {
+        if (error.empty() || csr.n != 0) {
+            std::cerr << fixture.file << ": ambiguous input was read" << std::endl;
+            return false;
+        }
+        // an explicit format still reads it
+        csr = csr_read(text.data(), text.size(), 1, "metis", &error);
+    } else if (!error.empty()) {
+        std::cerr << fixture.file << ": " << error << std::endl;
+        return false;
+    }
+
+    if (!check_cover(&csr, fixture.cover)) {
+        std::cerr << fixture.file << ": expected cover is not a cover" << std::endl;
+        return false;
+    }
+    std::vector<uint32_t> matched(csr.forced);
+    matched.insert(matched.end(), csr.matching.begin(), csr.matching.end());
+    if (!verify_cover(&csr, matched)) {
+        std::cerr << fixture.file << ": matching cover is not a cover" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::cerr << "usage: " << argv[0] << " <fixture dir>" << std::endl;
+        return 2;
+    }
+    unsigned long failed = 0;
+    for (const Fixture& fixture: fixtures) {
+        if (!run_fixture(argv[1], fixture)) failed++;
+    }
+    std::cout << fixtures.size() - failed << "/" << fixtures.size() << " reader fixtures passed" << std::endl;
+    return failed == 0 ? 0 : 1;
+}